@@ -1,21 +1,654 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include "usbkeyboard.h"
+#include "latency.h"
+#include "logger.h"
 #include "vga_ball.h"
+#include "vga_ball_regs.h"
 
 #define FLAP_KEY 0x2C  // USB keycode for spacebar
 #define ESC_KEY  0x29  // USB keycode for ESC
 #define DEVICE_FILE "/dev/vga_ball"
+#define MAX_EVENTS 8   // libusb normally exposes only a handful of fds
+#define FLAP_RING 64   // Flap events in flight between threads (power of 2)
+#define RT_PRIORITY 80 // SCHED_FIFO priority of the input and writer threads
 
-int main() {
-    struct libusb_device_handle *keyboard;
+static int vga_fd;
+static struct vga_ball_regs regs;  // Mapped registers, with -m
+static atomic_int quit;  // Set by the input thread, read by all, with -r
+static volatile sig_atomic_t report_requested;
+
+// Latency of each flap, measured from the arrival of its HID report.
+// Only the thread that sends flaps touches these; see print_latency().
+struct flap_latency {
+    struct latency_stats report_to_write;
+    struct latency_stats write_time;
+    struct latency_stats report_to_flap;
+};
+
+static struct flap_latency latency = {
+    .report_to_write = { .name = "report -> write entry" },
+    .write_time = { .name = "write entry -> exit" },
+    .report_to_flap = { .name = "report -> write exit" },
+};
+
+// Measured by the frame watcher, which is not real-time: see below
+static struct latency_stats report_to_frame = { .name = "report -> applied frame" };
+static pthread_mutex_t frame_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// In real-time mode the writer thread copies latency here when asked
+static struct flap_latency latency_snapshot;
+static atomic_int snapshot_requested;
+static sem_t snapshot_taken;
+static int writer_running;          // Main thread only
+static void request_snapshot(void);
+
+static void request_report(int sig)
+{
+    (void)sig;
+    report_requested = 1;
+}
+
+/*
+ * Print the latency report.  While the real-time writer thread is
+ * running it owns the statistics, so we ask it for a copy and print
+ * that: it never waits for us, however long sorting and printing take.
+ */
+static void print_latency(void)
+{
+    static struct latency_stats to_frame;
+    const struct flap_latency *l = &latency;
+
+    if (writer_running) {
+        request_snapshot();
+        l = &latency_snapshot;
+    }
+    pthread_mutex_lock(&frame_lock);
+    to_frame = report_to_frame;
+    pthread_mutex_unlock(&frame_lock);
+
+    fprintf(stderr, "Flap latency:\n");
+    latency_report(stderr, &l->report_to_write);
+    latency_report(stderr, &l->write_time);
+    latency_report(stderr, &l->report_to_flap);
+    latency_report(stderr, &to_frame);
+}
+
+/*
+ * Flap events in flight between threads: a lock-free
+ * single-producer/single-consumer ring
+ */
+struct flap_event {
+    struct timespec arrival;
+};
+
+struct flap_ring {
+    struct flap_event events[FLAP_RING];
+    _Atomic unsigned int head;  // Written only by the producer
+    _Atomic unsigned int tail;  // Written only by the consumer
+};
+
+static int flap_ring_push(struct flap_ring *ring, const struct flap_event *ev)
+{
+    unsigned int head = atomic_load_explicit(&ring->head,
+                                             memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail,
+                                             memory_order_acquire);
+
+    if (head - tail == FLAP_RING)
+        return 0;
+    ring->events[head % FLAP_RING] = *ev;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return 1;
+}
+
+static int flap_ring_pop(struct flap_ring *ring, struct flap_event *ev)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail,
+                                             memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head,
+                                             memory_order_acquire);
+
+    if (head == tail)
+        return 0;
+    *ev = ring->events[tail % FLAP_RING];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/*
+ * Frame watcher: measures the frame in which each flap took effect.
+ * Whichever thread sends flaps queues each one's report time in
+ * applied_ring after the write succeeds.  The watcher, an ordinary
+ * thread on its own descriptor, wakes at every vsync (read() returns
+ * the frame and its timestamp) and reads the flap counters.  Flaps
+ * applied since the last frame, received - dropped - pending, are
+ * matched in order with the queued report times, and each is recorded
+ * as taking effect at that vsync.  None of this is on the flap path.
+ *
+ * A flap that leaves WAITING or GAME_OVER takes effect at once, so it
+ * is measured to the vsync after it.  The hardware counts as dropped
+ * both flaps that found its queue full and flaps it emptied from the
+ * queue when a game ended or restarted.  Which of ours those were
+ * cannot be told, so a frame in which dropped moved resynchronizes the
+ * watcher instead, as does a full applied_ring.
+ */
+static struct flap_ring applied_ring;
+static atomic_int applied_lost;     // Set when applied_ring was full
+static int watch_fd = -1;
+static pthread_t watcher;
+
+// Flaps applied and dropped since reset, modulo 2^16
+static int read_flap_counts(uint16_t *applied, uint16_t *dropped)
+{
+    vga_ball_state_t state;
+
+    if (ioctl(watch_fd, VGA_BALL_READ_STATE, &state) == -1)
+        return -1;
+    *applied = state.flaps_received - state.flaps_dropped - state.flap_pending;
+    *dropped = state.flaps_dropped;
+    return 0;
+}
+
+static void *watcher_thread(void *arg)
+{
+    vga_ball_frame_t frame;
+    struct flap_event ev;
+    uint16_t applied, dropped, last_applied, last_dropped;
+    unsigned int owed = 0;          // Applied but not yet queued by the sender
+    uint64_t owed_at = 0, arrival;
+
+    (void)arg;
+    if (read_flap_counts(&last_applied, &last_dropped) == -1)
+        return NULL;
+
+    while (read(watch_fd, &frame, sizeof(frame)) == sizeof(frame)) {
+        if (read_flap_counts(&applied, &dropped) == -1)
+            break;
+
+        if (atomic_exchange(&applied_lost, 0) || dropped != last_dropped) {
+            // We cannot tell which flaps these were: start over
+            while (flap_ring_pop(&applied_ring, &ev))
+                ;
+            owed = 0;
+        } else if (applied != last_applied) {
+            if (owed == 0)
+                owed_at = frame.timestamp;
+            owed += (uint16_t)(applied - last_applied);
+        }
+        last_applied = applied;
+        last_dropped = dropped;
+
+        pthread_mutex_lock(&frame_lock);
+        for (; owed && flap_ring_pop(&applied_ring, &ev); owed--) {
+            arrival = (uint64_t)ev.arrival.tv_sec * 1000000000 +
+                      ev.arrival.tv_nsec;
+            latency_record(&report_to_frame,
+                           owed_at > arrival ? owed_at - arrival : 0);
+        }
+        pthread_mutex_unlock(&frame_lock);
+    }
+    return NULL;
+}
+
+/*
+ * Start the watcher on a descriptor of its own, so that its frame
+ * reads do not disturb anything else using the device.  Without it,
+ * the applied-frame statistic is simply empty.
+ */
+static void start_watcher(const char *device)
+{
+    sigset_t all, old;
+    int r;
+
+    if ((watch_fd = open(device, O_RDONLY)) == -1)
+        return;
+
+    // Signals are for the main thread: the watcher starts with all blocked
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    r = pthread_create(&watcher, NULL, watcher_thread, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (r != 0) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
+}
+
+static void stop_watcher(void)
+{
+    if (watch_fd == -1)
+        return;
+    pthread_cancel(watcher);  // It is normally blocked in read()
+    pthread_join(watcher, NULL);
+    close(watch_fd);
+    watch_fd = -1;
+}
+
+/*
+ * Send one flap and record its latency.  arrival is when the report
+ * that caused it came in (CLOCK_MONOTONIC).  Returns -1 if the ioctl
+ * failed.  With the registers mapped, the flap is a single store.
+ */
+static int send_flap(const struct timespec *arrival)
+{
+    struct timespec entry, done;
+    struct flap_event ev = { *arrival };
+    int r = 0;
+
+    // One-shot flap: the hardware queues it for the next vsync
+    clock_gettime(CLOCK_MONOTONIC, &entry);
+    if (regs.base)
+        vga_ball_regs_flap(&regs);
+    else
+        r = ioctl(vga_fd, VGA_BALL_FLAP);
+    clock_gettime(CLOCK_MONOTONIC, &done);
+
+    if (r != -1) {
+        latency_record(&latency.report_to_write, latency_ns(arrival, &entry));
+        latency_record(&latency.write_time, latency_ns(&entry, &done));
+        latency_record(&latency.report_to_flap, latency_ns(arrival, &done));
+        // The frame watcher measures when it takes effect
+        if (!flap_ring_push(&applied_ring, &ev))
+            atomic_store(&applied_lost, 1);
+    }
+    return r;
+}
+
+/*
+ * Act on one keyboard report: flap on SPACE, request exit on ESC.
+ */
+static void handle_packet(const struct usb_keyboard_packet *packet,
+                          const struct timespec *arrival)
+{
+    uint8_t code = packet->keycode[0];
+
+    if (code == FLAP_KEY) {
+        log_debug("SPACEBAR detected! Sending flap command...");
+
+        if (send_flap(arrival) == -1)
+            log_errno("ioctl(VGA_BALL_FLAP) failed");
+        else
+            log_debug("Flap triggered successfully!");
+    }
+
+    if (code == ESC_KEY) {
+        log_info("Exiting...");
+        atomic_store(&quit, 1);
+    }
+}
+
+// What the input loops do with each report
+static void (*on_packet)(const struct usb_keyboard_packet *,
+                         const struct timespec *) = handle_packet;
+
+/*
+ * Original loop: synchronous transfer with a 10ms timeout, then sleep.
+ */
+static void run_polling(struct libusb_device_handle *keyboard,
+                        uint8_t endpoint_address)
+{
     struct usb_keyboard_packet packet;
-    uint8_t endpoint_address;
+    struct timespec arrival;
     int transferred;
-    int vga_fd;
+
+    while (!atomic_load(&quit)) {
+        // Poll keyboard with a timeout of 10ms
+        int result = libusb_interrupt_transfer(keyboard, endpoint_address,
+            (unsigned char *)&packet, sizeof(packet),
+            &transferred, 10);
+
+        if (result == 0 && transferred == sizeof(packet)) {
+            clock_gettime(CLOCK_MONOTONIC, &arrival);
+            on_packet(&packet, &arrival);
+        } else if (result != 0 && result != LIBUSB_ERROR_TIMEOUT) {
+            // Only report non-timeout errors
+            log_error("libusb_interrupt_transfer error: %ld", (long)result);
+        }
+
+        usleep(10000);  // 10ms sleep to avoid CPU hogging
+
+        if (report_requested) {
+            report_requested = 0;
+            print_latency();
+        }
+    }
+}
+
+/*
+ * Event-driven loop: the async keyboard reader keeps interrupt transfers
+ * queued on the endpoint and we sleep in epoll on libusb's file
+ * descriptors, so a report is handled as soon as the host controller
+ * completes it.
+ */
+static void LIBUSB_CALL pollfd_added(int fd, short events, void *user_data)
+{
+    int epfd = *(int *)user_data;
+    struct epoll_event ev = { .events = events, .data.fd = fd };
+
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+        log_errno("epoll_ctl(EPOLL_CTL_ADD) failed");
+}
+
+static void LIBUSB_CALL pollfd_removed(int fd, void *user_data)
+{
+    int epfd = *(int *)user_data;
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+static void run_event_driven(struct libusb_device_handle *keyboard,
+                             uint8_t endpoint_address)
+{
+    struct usb_keyboard_reader *reader;
+    struct usb_keyboard_packet packet;
+    struct timespec arrival;
+    const struct libusb_pollfd **pollfds;
+    struct epoll_event events[MAX_EVENTS];
+    struct timeval zero = { 0, 0 };
+    int epfd, i;
+
+    if ((epfd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+        perror("epoll_create1 failed");
+        return;
+    }
+
+    // Watch every fd libusb already has, and track any it adds later
+    if ((pollfds = libusb_get_pollfds(NULL)) == NULL) {
+        fprintf(stderr, "libusb_get_pollfds failed\n");
+        close(epfd);
+        return;
+    }
+    for (i = 0; pollfds[i] != NULL; i++)
+        pollfd_added(pollfds[i]->fd, pollfds[i]->events, &epfd);
+    libusb_free_pollfds(pollfds);
+    libusb_set_pollfd_notifiers(NULL, pollfd_added, pollfd_removed, &epfd);
+
+    if ((reader = usbkeyboard_start(keyboard, endpoint_address)) == NULL) {
+        fprintf(stderr, "Could not start the keyboard reader.\n");
+        goto out;
+    }
+
+    while (!atomic_load(&quit)) {
+        int timeout = -1;
+        struct timeval tv;
+
+        // Only needed where libusb cannot expose its timeouts as an fd
+        if (!libusb_pollfds_handle_timeouts(NULL) &&
+            libusb_get_next_timeout(NULL, &tv) == 1)
+            timeout = tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000;
+
+        if (report_requested) {
+            report_requested = 0;
+            print_latency();
+        }
+
+        if (epoll_wait(epfd, events, MAX_EVENTS, timeout) == -1) {
+            if (errno == EINTR)
+                continue;
+            log_errno("epoll_wait failed");
+            break;
+        }
+
+        // Dispatch completed transfers without blocking
+        libusb_handle_events_timeout_completed(NULL, &zero, NULL);
+
+        while (!atomic_load(&quit) &&
+               (i = usbkeyboard_next(reader, &packet, &arrival)) != 0) {
+            if (i < 0) {
+                log_error("Keyboard reader stopped.");
+                atomic_store(&quit, 1);
+                break;
+            }
+            on_packet(&packet, &arrival);
+        }
+    }
+
+    if (usbkeyboard_dropped(reader))
+        fprintf(stderr, "Dropped %lu keyboard reports\n",
+                usbkeyboard_dropped(reader));
+    usbkeyboard_stop(reader);
+ out:
+    libusb_set_pollfd_notifiers(NULL, NULL, NULL, NULL);
+    close(epfd);
+}
+
+/*
+ * Real-time mode: a SCHED_FIFO input thread runs the event-driven loop
+ * and hands flaps to a SCHED_FIFO writer thread through flap_ring; the
+ * writer updates the device.  Neither thread touches stdio: messages go
+ * through the async logger and the main thread prints the latency report
+ * at the end or on SIGUSR1.
+ */
+static struct flap_ring flap_ring;  // From the input to the writer thread
+
+static int flap_wake_fd;                // eventfd: wakes the writer thread
+static atomic_int writer_stop;
+static pthread_t main_thread;
+static unsigned long flaps_dropped;     // Ring full; input thread only
+static atomic_ulong flap_errors;
+
+static void wake_writer(void)
+{
+    uint64_t one = 1;
+
+    if (write(flap_wake_fd, &one, sizeof(one)) != sizeof(one))
+        flap_errors++;
+}
+
+/*
+ * Main thread: ask the writer for a copy of the statistics and wait for
+ * it.  The writer answers between flaps, so this takes at most one flap.
+ */
+static void request_snapshot(void)
+{
+    atomic_store(&snapshot_requested, 1);
+    wake_writer();
+    while (sem_wait(&snapshot_taken) == -1 && errno == EINTR)
+        ;
+}
+
+// Writer thread: answer a pending request, without ever blocking
+static void take_snapshot(void)
+{
+    if (atomic_exchange(&snapshot_requested, 0)) {
+        latency_snapshot = latency;
+        sem_post(&snapshot_taken);
+    }
+}
+
+static void queue_packet(const struct usb_keyboard_packet *packet,
+                         const struct timespec *arrival)
+{
+    uint8_t code = packet->keycode[0];
+
+    if (code == FLAP_KEY) {
+        struct flap_event ev = { *arrival };
+
+        if (flap_ring_push(&flap_ring, &ev))
+            wake_writer();
+        else
+            flaps_dropped++;
+    }
+
+    if (code == ESC_KEY)
+        atomic_store(&quit, 1);
+}
+
+struct input_args {
+    struct libusb_device_handle *keyboard;
+    uint8_t endpoint_address;
+};
+
+static void *input_thread(void *arg)
+{
+    struct input_args *args = arg;
+
+    run_event_driven(args->keyboard, args->endpoint_address);
+    atomic_store(&quit, 1);
+    pthread_kill(main_thread, SIGUSR2);  // Tell main we are done
+    return NULL;
+}
+
+static void *writer_thread(void *arg)
+{
+    struct flap_event ev;
+    uint64_t count;
+
+    (void)arg;
+    while (!atomic_load(&writer_stop)) {
+        if (read(flap_wake_fd, &count, sizeof(count)) != sizeof(count) &&
+            errno != EINTR)
+            break;
+        while (flap_ring_pop(&flap_ring, &ev))
+            if (send_flap(&ev.arrival) == -1) {
+                log_errno("ioctl(VGA_BALL_FLAP) failed");
+                flap_errors++;
+            }
+        take_snapshot();
+    }
+    take_snapshot();  // In case main asked as we stopped
+    return NULL;
+}
+
+/*
+ * Start a thread at SCHED_FIFO priority, falling back to the default
+ * policy (with a warning) if we lack the privilege.
+ */
+static int start_rt_thread(pthread_t *thread, void *(*fn)(void *), void *arg)
+{
+    pthread_attr_t attr;
+    struct sched_param param = { .sched_priority = RT_PRIORITY };
+    int r;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+    r = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+
+    if (r == EPERM) {
+        fprintf(stderr, "No permission for SCHED_FIFO; using default policy\n");
+        r = pthread_create(thread, NULL, fn, arg);
+    }
+    return r;
+}
+
+static void run_realtime(struct libusb_device_handle *keyboard,
+                         uint8_t endpoint_address)
+{
+    struct input_args args = { keyboard, endpoint_address };
+    pthread_t input, writer;
+    sigset_t signals;
+    int sig;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1)
+        perror("mlockall failed; page faults may add latency");
+
+    if ((flap_wake_fd = eventfd(0, EFD_CLOEXEC)) == -1) {
+        perror("eventfd failed");
+        return;
+    }
+    sem_init(&snapshot_taken, 0, 0);
+
+    // Only the main thread takes SIGUSR1/SIGUSR2; workers inherit the mask
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    sigaddset(&signals, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    main_thread = pthread_self();
+    on_packet = queue_packet;
+
+    if (start_rt_thread(&writer, writer_thread, NULL) != 0) {
+        fprintf(stderr, "Could not start the writer thread.\n");
+        goto out;
+    }
+    writer_running = 1;
+    if (start_rt_thread(&input, input_thread, &args) != 0) {
+        fprintf(stderr, "Could not start the input thread.\n");
+        goto out_writer;
+    }
+
+    while (sigwait(&signals, &sig) == 0 && sig == SIGUSR1)
+        print_latency();
+    pthread_join(input, NULL);
+    log_info("Exiting...");
+
+ out_writer:
+    atomic_store(&writer_stop, 1);
+    wake_writer();
+    pthread_join(writer, NULL);
+    writer_running = 0;
+    if (flaps_dropped || flap_errors)
+        fprintf(stderr, "Flaps dropped: %lu, failed: %lu\n",
+                flaps_dropped, atomic_load(&flap_errors));
+ out:
+    pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
+    sem_destroy(&snapshot_taken);
+    close(flap_wake_fd);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-p | -r] [-m] [-v | -q] [-d device]\n"
+            "  -d  drive this display instead of " DEVICE_FILE "\n"
+            "  -p  poll the keyboard every 10ms instead of waiting on events\n"
+            "  -r  read the keyboard and write the device on real-time threads\n"
+            "  -m  write the registers through mmap instead of ioctl\n"
+            "  -v  log every flap\n"
+            "  -q  log errors only\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    struct libusb_device_handle *keyboard;
+    uint8_t endpoint_address;
+    struct sigaction sa;
+    const char *device = DEVICE_FILE;
+    int polling = 0, realtime = 0, mapped = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:prmvq")) != -1) {
+        switch (opt) {
+        case 'd':
+            device = optarg;
+            break;
+        case 'p':
+            polling = 1;
+            break;
+        case 'r':
+            realtime = 1;
+            break;
+        case 'm':
+            mapped = 1;
+            break;
+        case 'v':
+            logger_level = LOG_LEVEL_DEBUG;
+            break;
+        case 'q':
+            logger_level = LOG_LEVEL_ERROR;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
 
     // Open USB keyboard
     printf("Opening USB keyboard...\n");
@@ -27,56 +660,51 @@ int main() {
 
     // Open memory-mapped peripheral
     printf("Opening VGA Ball device...\n");
-    vga_fd = open(DEVICE_FILE, O_RDWR);
+    vga_fd = open(device, O_RDWR);
     if (vga_fd < 0) {
-        perror("Failed to open /dev/vga_ball");
+        perror(device);
         libusb_close(keyboard);
         return 1;
     }
+    if (mapped && vga_ball_regs_map(&regs, vga_fd) == -1) {
+        perror("Failed to mmap the VGA Ball registers");
+        close(vga_fd);
+        libusb_close(keyboard);
+        return 1;
+    }
+
+    // SIGUSR1 prints the latency report; no SA_RESTART so epoll wakes up
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = request_report;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
 
     printf("Press SPACE to flap the bird. Press ESC to quit.\n");
 
-    // Main loop
-    while (1) {
-        // Poll keyboard with a timeout of 10ms
-        int result = libusb_interrupt_transfer(keyboard, endpoint_address,
-            (unsigned char *)&packet, sizeof(packet),
-            &transferred, 10);
+    // Messages from the input path are printed by the logger's thread
+    if (logger_start() != 0) {
+        fprintf(stderr, "Could not start the logger.\n");
+        close(vga_fd);
+        libusb_close(keyboard);
+        return 1;
+    }
 
-        if (result == 0 && transferred == sizeof(packet)) {
-            uint8_t code = packet.keycode[0];
-
-            if (code == FLAP_KEY) {
-                printf("SPACEBAR detected! Sending flap command...\n");
-                
-                // Trigger the flap command to FPGA using IOCTL
-                vga_ball_arg_t vla = {0};  // Initialize all fields to 0
-                vla.flap = 1;              // Set flap bit
-                
-                if (ioctl(vga_fd, VGA_BALL_WRITE_FLAP, &vla) == -1) {
-                    perror("ioctl(VGA_BALL_WRITE_FLAP) failed");
-                } else {
-                    printf("Flap triggered successfully!\n");
-					usleep(20000);  // 20ms should be enough for at least one frame
-
-					// Reset flap signal
-					vla.flap = 0;
-					ioctl(vga_fd, VGA_BALL_WRITE_FLAP, &vla);
-                }
-            }
+    start_watcher(device);
 
-            if (code == ESC_KEY) {
-                printf("Exiting...\n");
-                break;
-            }
-        } else if (result != 0 && result != LIBUSB_ERROR_TIMEOUT) {
-            // Only report non-timeout errors
-            fprintf(stderr, "libusb_interrupt_transfer error: %d\n", result);
-        }
+    // Main loop
+    if (polling)
+        run_polling(keyboard, endpoint_address);
+    else if (realtime)
+        run_realtime(keyboard, endpoint_address);
+    else
+        run_event_driven(keyboard, endpoint_address);
 
-        usleep(10000);  // 10ms sleep to avoid CPU hogging
-    }
+    stop_watcher();
+    logger_stop();
+    print_latency();
 
+    if (regs.base)
+        vga_ball_regs_unmap(&regs);
     close(vga_fd);
     libusb_close(keyboard);
     return 0;
@@ -0,0 +1,65 @@
+#include "latency.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t latency_ns(const struct timespec *from, const struct timespec *to) {
+  return (uint64_t) (to->tv_sec - from->tv_sec) * 1000000000ull
+    + to->tv_nsec - from->tv_nsec;
+}
+
+void latency_record(struct latency_stats *stats, uint64_t ns) {
+  stats->samples[stats->count % LATENCY_SAMPLES] = ns;
+  stats->count++;
+  if (ns > stats->max)
+    stats->max = ns;
+}
+
+static int compare_samples(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+/*
+ * Nearest-rank percentile of a sorted array of n > 0 samples
+ */
+static uint64_t percentile(const uint64_t *sorted, unsigned n, unsigned p) {
+  unsigned rank = (n * p + 99) / 100;
+  return sorted[rank ? rank - 1 : 0];
+}
+
+void latency_report(FILE *f, const struct latency_stats *stats) {
+  static uint64_t sorted[LATENCY_SAMPLES];
+  unsigned n = stats->count < LATENCY_SAMPLES ? stats->count : LATENCY_SAMPLES;
+
+  if (n == 0) {
+    fprintf(f, "%-24s no samples\n", stats->name);
+    return;
+  }
+
+  memcpy(sorted, stats->samples, n * sizeof(uint64_t));
+  qsort(sorted, n, sizeof(uint64_t), compare_samples);
+
+  fprintf(f, "%-24s n=%-6lu p50=%8.3f p90=%8.3f p99=%8.3f max=%8.3f ms\n",
+	  stats->name, stats->count,
+	  percentile(sorted, n, 50) / 1e6, percentile(sorted, n, 90) / 1e6,
+	  percentile(sorted, n, 99) / 1e6, stats->max / 1e6);
+
+  /* Power-of-two buckets from 1/8 ms up; the last one is open-ended */
+  {
+    unsigned buckets[LATENCY_BUCKETS] = { 0 };
+    unsigned i, b;
+    for (i = 0 ; i < n ; i++) {
+      uint64_t limit = 125000;
+      for (b = 0 ; b < LATENCY_BUCKETS - 1 && sorted[i] >= limit ; b++)
+	limit *= 2;
+      buckets[b]++;
+    }
+    fprintf(f, "%-24s", "");
+    for (b = 0 ; b < LATENCY_BUCKETS ; b++)
+      fprintf(f, " %s%g:%u", b == LATENCY_BUCKETS - 1 ? ">=" : "<",
+	      0.125 * (1 << (b == LATENCY_BUCKETS - 1 ? b - 1 : b)),
+	      buckets[b]);
+    fprintf(f, "\n");
+  }
+}
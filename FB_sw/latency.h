@@ -0,0 +1,31 @@
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* Samples kept per statistic; older samples are overwritten */
+#define LATENCY_SAMPLES 4096
+
+/* Histogram buckets: <0.125 ms, <0.25 ms, ..., <16 ms, >=16 ms */
+#define LATENCY_BUCKETS 9
+
+struct latency_stats {
+  const char *name;
+  unsigned long count;              /* Samples ever recorded */
+  uint64_t max;                     /* Largest sample ever recorded */
+  uint64_t samples[LATENCY_SAMPLES];
+};
+
+/* Nanoseconds from one CLOCK_MONOTONIC timestamp to a later one */
+extern uint64_t latency_ns(const struct timespec *, const struct timespec *);
+
+/* Record one sample, in nanoseconds */
+extern void latency_record(struct latency_stats *, uint64_t);
+
+/* Print count, p50/p90/p99 over the retained samples, max, and a
+   histogram of the retained samples */
+extern void latency_report(FILE *, const struct latency_stats *);
+
+#endif
@@ -0,0 +1,175 @@
+#include "logger.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Bounded multi-producer/single-consumer queue after Dmitry Vyukov:
+ * each slot carries a sequence number that tells producers whether it
+ * is free and the consumer whether it has been filled.
+ */
+
+#define DRAIN_INTERVAL_US 2000  /* How often the thread looks for records */
+
+struct record {
+  atomic_uint seq;
+  int level;
+  int err;
+  const char *fmt;
+  long args[LOGGER_ARGS];
+};
+
+int logger_level = LOG_LEVEL_INFO;
+
+static struct record ring[LOGGER_RING];
+static atomic_uint enqueue_pos;
+static unsigned int dequeue_pos;      /* Drain thread only */
+static atomic_ulong dropped;
+static atomic_ulong rejected;
+static atomic_int stopping;
+static pthread_t drain_thread;
+
+/*
+ * Number of conversions in fmt, or -1 if one is not of a long (%ld,
+ * %li, %lu, %lx, %lX or %lo, with any flags, width and precision)
+ */
+static int long_conversions(const char *fmt) {
+  int n = 0;
+
+  while ((fmt = strchr(fmt, '%')) != NULL) {
+    if (*++fmt == '%') {
+      fmt++;
+      continue;
+    }
+    fmt += strspn(fmt, "-+ #0123456789.");
+    if (*fmt++ != 'l' || !*fmt || !strchr("diuxXo", *fmt))
+      return -1;
+    n++;
+  }
+  return n;
+}
+
+void logger_write(int level, int err, atomic_schar *checked,
+                  const char *fmt, ...) {
+  unsigned int pos;
+  struct record *r;
+  va_list ap;
+  int i, n = atomic_load_explicit(checked, memory_order_relaxed);
+
+  /* Scan the format on its first use only; threads that race here
+     store the same answer */
+  if (n == 0) {
+    n = long_conversions(fmt);
+    n = n < 0 || n > LOGGER_ARGS ? -1 : n + 1;
+    atomic_store_explicit(checked, n, memory_order_relaxed);
+  }
+  if (n < 0) {
+#ifndef NDEBUG
+    fprintf(stderr, "logger: format must take at most %d longs: \"%s\"\n",
+            LOGGER_ARGS, fmt);
+    abort();
+#endif
+    atomic_fetch_add_explicit(&rejected, 1, memory_order_relaxed);
+    return;
+  }
+  n--;
+
+  pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+  for (;;) {
+    int diff;
+    r = &ring[pos % LOGGER_RING];
+    diff = (int) (atomic_load_explicit(&r->seq, memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+      return;
+    } else
+      pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+  }
+
+  r->level = level;
+  r->err = err;
+  r->fmt = fmt;
+  va_start(ap, fmt);
+  for (i = 0 ; i < LOGGER_ARGS ; i++)
+    r->args[i] = i < n ? va_arg(ap, long) : 0;
+  va_end(ap);
+  atomic_store_explicit(&r->seq, pos + 1, memory_order_release);
+}
+
+static void print_record(const struct record *r) {
+  FILE *f = r->level == LOG_LEVEL_ERROR ? stderr : stdout;
+
+  /* logger_write() let through only formats of up to three longs */
+  fprintf(f, r->fmt, r->args[0], r->args[1], r->args[2]);
+  if (r->err)
+    fprintf(f, ": %s", strerror(r->err));
+  fputc('\n', f);
+}
+
+/*
+ * Print every filled record; returns how many there were
+ */
+static int drain(void) {
+  int n = 0;
+
+  for (;;) {
+    struct record *r = &ring[dequeue_pos % LOGGER_RING];
+    if (atomic_load_explicit(&r->seq, memory_order_acquire) != dequeue_pos + 1)
+      break;
+    print_record(r);
+    atomic_store_explicit(&r->seq, dequeue_pos + LOGGER_RING,
+                          memory_order_release);
+    dequeue_pos++;
+    n++;
+  }
+  if (n)
+    fflush(stdout);
+  return n;
+}
+
+static void *drain_main(void *arg) {
+  (void) arg;
+  while (!atomic_load(&stopping))
+    if (drain() == 0)
+      usleep(DRAIN_INTERVAL_US);
+  drain();
+  return NULL;
+}
+
+int logger_start(void) {
+  sigset_t all, old;
+  unsigned int i;
+  int r;
+
+  for (i = 0 ; i < LOGGER_RING ; i++)
+    atomic_init(&ring[i].seq, i);
+
+  /* Signals are for the program's threads: the drain thread blocks all */
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  r = pthread_create(&drain_thread, NULL, drain_main, NULL);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  return r;
+}
+
+void logger_stop(void) {
+  atomic_store(&stopping, 1);
+  pthread_join(drain_thread, NULL);
+  if (atomic_load(&dropped))
+    fprintf(stderr, "logger: dropped %lu records\n", atomic_load(&dropped));
+  if (atomic_load(&rejected))
+    fprintf(stderr, "logger: rejected %lu records with bad formats\n",
+            atomic_load(&rejected));
+}
@@ -0,0 +1,57 @@
+#ifndef _LOGGER_H
+#define _LOGGER_H
+
+#include <stdatomic.h>
+
+/* Asynchronous logger.  Callers copy a fixed-size record (format
+   pointer plus up to LOGGER_ARGS long arguments) into a preallocated
+   ring; a background thread formats and prints it.  The format string
+   must therefore outlive the call (use literals) and consume only
+   long-sized arguments (%ld, %li, %lu, %lx, %lX, %lo).  The compiler
+   checks the arguments against the format; the format itself is
+   checked once per call site, the first time it logs.  A format with
+   any other conversion, or more than LOGGER_ARGS, aborts the program
+   unless NDEBUG is defined, in which case its records are rejected.
+   Safe to call from any thread; records are dropped when the ring is
+   full.  Dropped and rejected records are counted. */
+
+#define LOGGER_ARGS 3
+#define LOGGER_RING 256   /* Records; must be a power of two */
+
+enum {
+  LOG_LEVEL_ERROR,        /* Printed to stderr */
+  LOG_LEVEL_INFO,         /* Printed to stdout */
+  LOG_LEVEL_DEBUG,        /* Printed to stdout */
+};
+
+/* Records above this level are discarded at the call site */
+extern int logger_level;
+
+/* Start the drain thread.  Returns 0 or an errno value. */
+extern int logger_start(void);
+
+/* Print everything still queued, report drops, and stop the thread */
+extern void logger_stop(void);
+
+/* Queue a record of fmt and its long arguments; err, if nonzero, is
+   appended as strerror(err).  checked caches, for the call site, the
+   number of arguments fmt takes plus one, or -1 if it is bad; it
+   starts at 0, unchecked. */
+extern void logger_write(int level, int err, atomic_schar *checked,
+                         const char *fmt, ...)
+  __attribute__((format(printf, 4, 5)));
+
+/* The arguments are the format and then its arguments, if any */
+#define LOGGER(level, err, ...)                                         \
+  do {                                                                  \
+    static atomic_schar logger_checked;                                 \
+    if ((level) <= logger_level)                                        \
+      logger_write((level), (err), &logger_checked, __VA_ARGS__);       \
+  } while (0)
+
+#define log_error(...) LOGGER(LOG_LEVEL_ERROR, 0, __VA_ARGS__)
+#define log_errno(...) LOGGER(LOG_LEVEL_ERROR, errno, __VA_ARGS__)
+#define log_info(...)  LOGGER(LOG_LEVEL_INFO, 0, __VA_ARGS__)
+#define log_debug(...) LOGGER(LOG_LEVEL_DEBUG, 0, __VA_ARGS__)
+
+#endif
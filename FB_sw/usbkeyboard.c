@@ -80,3 +80,110 @@ struct libusb_device_handle *openkeyboard(uint8_t *endpoint_address) {
 
   return keyboard;
 }
+
+struct usb_keyboard_reader {
+  struct libusb_transfer *transfers[USB_KEYBOARD_TRANSFERS];
+  struct usb_keyboard_packet buffers[USB_KEYBOARD_TRANSFERS];
+  struct usb_keyboard_packet ring[USB_KEYBOARD_RING];
+  struct timespec arrival[USB_KEYBOARD_RING];
+  unsigned int head, tail;  /* head: next to write, tail: next to read */
+  int in_flight;
+  int stopping;
+  unsigned long dropped;
+};
+
+/*
+ * Called by libusb when one of the reader's transfers completes:
+ * queue the report and immediately hand the transfer back to the host
+ * controller
+ */
+static void LIBUSB_CALL reader_callback(struct libusb_transfer *transfer)
+{
+  struct usb_keyboard_reader *reader = transfer->user_data;
+
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED &&
+      transfer->actual_length == sizeof(struct usb_keyboard_packet)) {
+    if (reader->head - reader->tail < USB_KEYBOARD_RING) {
+      unsigned int slot = reader->head % USB_KEYBOARD_RING;
+      clock_gettime(CLOCK_MONOTONIC, &reader->arrival[slot]);
+      reader->ring[slot] = *(struct usb_keyboard_packet *) transfer->buffer;
+      reader->head++;
+    } else
+      reader->dropped++;
+  }
+
+  if (reader->stopping ||
+      transfer->status == LIBUSB_TRANSFER_CANCELLED ||
+      transfer->status == LIBUSB_TRANSFER_NO_DEVICE ||
+      libusb_submit_transfer(transfer) != 0)
+    reader->in_flight--;
+}
+
+struct usb_keyboard_reader *usbkeyboard_start(struct libusb_device_handle *keyboard,
+					      uint8_t endpoint_address) {
+  struct usb_keyboard_reader *reader;
+  int t, r;
+
+  if ( (reader = calloc(1, sizeof(*reader))) == NULL )
+    return NULL;
+
+  for (t = 0 ; t < USB_KEYBOARD_TRANSFERS ; t++) {
+    struct libusb_transfer *transfer = libusb_alloc_transfer(0);
+    if (transfer == NULL) {
+      fprintf(stderr, "Error: libusb_alloc_transfer failed\n");
+      break;
+    }
+    libusb_fill_interrupt_transfer(transfer, keyboard, endpoint_address,
+				   (unsigned char *) &reader->buffers[t],
+				   sizeof(struct usb_keyboard_packet),
+				   reader_callback, reader, 0);
+    reader->transfers[t] = transfer;
+    if ((r = libusb_submit_transfer(transfer)) != 0) {
+      fprintf(stderr, "Error: libusb_submit_transfer failed: %d\n", r);
+      break;
+    }
+    reader->in_flight++;
+  }
+
+  if (reader->in_flight == 0) {
+    usbkeyboard_stop(reader);
+    return NULL;
+  }
+
+  return reader;
+}
+
+int usbkeyboard_next(struct usb_keyboard_reader *reader,
+		     struct usb_keyboard_packet *packet,
+		     struct timespec *arrival) {
+  if (reader->tail == reader->head)
+    return reader->in_flight > 0 ? 0 : -1;
+
+  *packet = reader->ring[reader->tail % USB_KEYBOARD_RING];
+  if (arrival != NULL)
+    *arrival = reader->arrival[reader->tail % USB_KEYBOARD_RING];
+  reader->tail++;
+  return 1;
+}
+
+unsigned long usbkeyboard_dropped(struct usb_keyboard_reader *reader) {
+  return reader->dropped;
+}
+
+void usbkeyboard_stop(struct usb_keyboard_reader *reader) {
+  int t;
+
+  reader->stopping = 1;
+  for (t = 0 ; t < USB_KEYBOARD_TRANSFERS ; t++)
+    if (reader->transfers[t] != NULL)
+      libusb_cancel_transfer(reader->transfers[t]);
+
+  /* The callbacks must have run before the transfers can be freed */
+  while (reader->in_flight > 0)
+    if (libusb_handle_events(NULL) < 0)
+      break;
+
+  for (t = 0 ; t < USB_KEYBOARD_TRANSFERS ; t++)
+    libusb_free_transfer(reader->transfers[t]);
+  free(reader);
+}
@@ -2,6 +2,7 @@
 #define _USBKEYBOARD_H
 
 #include <libusb-1.0/libusb.h>
+#include <time.h>
 
 #define USB_HID_KEYBOARD_PROTOCOL 1
 
@@ -26,4 +27,35 @@ struct usb_keyboard_packet {
    device was found. */
 extern struct libusb_device_handle *openkeyboard(uint8_t *);
 
+/* Asynchronous reader: keeps USB_KEYBOARD_TRANSFERS interrupt transfers
+   queued on the keyboard endpoint so the endpoint is never left
+   unserviced between reports.  Completed reports are queued in a ring
+   of USB_KEYBOARD_RING entries (a power of two) from inside
+   libusb_handle_events*(), so the reader must be serviced by whichever
+   thread drives libusb's event loop. */
+#define USB_KEYBOARD_TRANSFERS 4
+#define USB_KEYBOARD_RING 64
+
+struct usb_keyboard_reader;
+
+/* Submit the transfers for the given keyboard and endpoint.  Returns
+   NULL if no transfer could be submitted. */
+extern struct usb_keyboard_reader *
+usbkeyboard_start(struct libusb_device_handle *, uint8_t);
+
+/* Take the oldest queued report without blocking, along with the
+   CLOCK_MONOTONIC time its transfer completed (if the last argument is
+   not NULL).  Returns 1 if a report was copied out, 0 if the ring is
+   empty, and -1 once the ring is empty and no transfer is left in
+   flight (e.g., the keyboard was unplugged). */
+extern int usbkeyboard_next(struct usb_keyboard_reader *,
+                            struct usb_keyboard_packet *,
+                            struct timespec *);
+
+/* Number of reports discarded because the ring was full */
+extern unsigned long usbkeyboard_dropped(struct usb_keyboard_reader *);
+
+/* Cancel the outstanding transfers, wait for them and free the reader */
+extern void usbkeyboard_stop(struct usb_keyboard_reader *);
+
 #endif
@@ -17,6 +17,111 @@ typedef struct {
     unsigned char flap;  // for passing flap input
 } vga_ball_arg_t;
 
+/* One register write: reg is a VGA_BALL_REG_* offset (vga_ball_regs.h) */
+typedef struct {
+    unsigned int reg;
+    unsigned int value;             // The whole 32-bit register
+} vga_ball_write_t;
+
+/* A batch of register writes applied in order by one ioctl */
+typedef struct {
+    unsigned long long writes;  // User pointer to count vga_ball_write_t
+    unsigned int count;
+    unsigned int applied;       // Set by the driver
+} vga_ball_batch_t;
+
+/* Game states reported by the hardware */
+#define VGA_BALL_STATE_WAITING   0
+#define VGA_BALL_STATE_PLAYING   1
+#define VGA_BALL_STATE_GAME_OVER 2
+
+#define VGA_BALL_PIPES 3
+
+/* Live game state read back from the hardware */
+typedef struct {
+    unsigned short score;
+    unsigned short bird_y;
+    unsigned char game_state;       // VGA_BALL_STATE_*
+    unsigned char flap_pending;     // Flaps queued, not yet applied
+    unsigned short flaps_received;  // Flap writes since reset (wraps)
+    unsigned short flaps_dropped;   // Lost to a full queue or game over
+    struct {
+        unsigned short x, gap_y;
+    } pipes[VGA_BALL_PIPES];
+} vga_ball_state_t;
+
+/* Hardware frame and 50 MHz cycle counters, sampled together */
+typedef struct {
+    unsigned int frame;             // Vsync edges since reset
+    unsigned int vsync_cycles;      // Low word of cycles at the last one
+    unsigned long long cycles;      // Clock cycles since reset
+} vga_ball_time_t;
+
+/* What read() on /dev/vga_ball returns: blocks until the next frame */
+typedef struct {
+    unsigned int frame;             // Vsync interrupts since the driver loaded
+    unsigned int reserved;
+    unsigned long long timestamp;   // CLOCK_MONOTONIC of the vsync, in ns
+} vga_ball_frame_t;
+
+/* Game events, in the order the driver reports them within one frame */
+#define VGA_BALL_EVENT_SCORE     0  // The score went up
+#define VGA_BALL_EVENT_COLLISION 1  // The bird hit a pipe or the ground
+#define VGA_BALL_EVENT_STATE     2  // game_state changed
+#define VGA_BALL_EVENTS          3
+
+/* What read() returns in VGA_BALL_READ_EVENTS mode: one record per event */
+typedef struct {
+    unsigned int type;              // VGA_BALL_EVENT_*
+    unsigned int frame;             // Vsync interrupt that reported it
+    unsigned long long timestamp;   // CLOCK_MONOTONIC of that vsync, in ns
+    unsigned short score;           // After the event
+    unsigned char game_state;       // After the event
+    unsigned char reserved[5];
+} vga_ball_event_t;
+
+/* What read() returns, chosen per open file with VGA_BALL_SET_READ_MODE */
+#define VGA_BALL_READ_FRAMES 0  // vga_ball_frame_t per new frame (default)
+#define VGA_BALL_READ_EVENTS 1  // As many whole vga_ball_event_t as fit
+
+/* write() on /dev/vga_ball takes an array of 32-bit VGA_BALL_CMD() words
+   (vga_ball_regs.h) and queues them in the hardware command FIFO; it
+   blocks while the FIFO is full and returns the bytes queued */
+
+/* Backgrounds in HPS memory, which the hardware reads by DMA instead
+   of drawing its tiles.  mmap() background i at offset
+   VGA_BALL_MMAP_BACKGROUND(i), fill it with 640x480 bytes (one BBBGGGRR
+   pixel each, row by row, as in bg.mif) and show it with
+   VGA_BALL_SHOW_BACKGROUND; offset 0 maps the registers. */
+#define VGA_BALL_BACKGROUNDS        2
+#define VGA_BALL_BACKGROUND_SIZE    (640 * 480)
+#define VGA_BALL_MMAP_BACKGROUND(i) (((i) + 1) * 0x100000)
+#define VGA_BALL_BACKGROUND_TILES   0xff  // Show the tiles again
+
+/* Hardware sprites.  Each shows one entry (its frame) of the image
+   table, an area of the sprite sheet, with its top left corner at
+   (x, y); either may be negative.  Sprites 0 and 1 are the bird and the
+   game over banner, which the game moves itself; the rest start
+   disabled.  The table starts with the bird's three frames and the
+   banner; vga_ball_regs.h has the registers for the rest. */
+#define VGA_BALL_SPRITES     16
+#define VGA_BALL_HW_SPRITES  2   // Sprites 0 and 1 belong to the game
+#define VGA_BALL_IMAGES      16
+
+/* Sprite priorities; within one, higher-numbered sprites are in front */
+#define VGA_BALL_SPRITE_BACK   0  // Behind the pipes and the ground
+#define VGA_BALL_SPRITE_MIDDLE 1  // In front of those, behind the score
+#define VGA_BALL_SPRITE_FRONT  2  // In front of everything
+
+typedef struct {
+    unsigned int index;             // VGA_BALL_HW_SPRITES and up
+    short x, y;                     // -1024 to 1023
+    unsigned char frame;            // Image table entry
+    unsigned char priority;         // VGA_BALL_SPRITE_*
+    unsigned char enable;
+    unsigned char reserved;
+} vga_ball_sprite_t;
+
 #define VGA_BALL_MAGIC 'q'
 /* ioctls and their arguments */
 #define VGA_BALL_WRITE_BACKGROUND _IOW(VGA_BALL_MAGIC, 1, vga_ball_arg_t)
@@ -24,5 +129,27 @@ typedef struct {
 #define VGA_BALL_WRITE_BALL _IOW(VGA_BALL_MAGIC, 3, vga_ball_arg_t)
 #define VGA_BALL_READ_BALL _IOR(VGA_BALL_MAGIC, 4, vga_ball_arg_t)
 #define VGA_BALL_WRITE_FLAP _IOW(VGA_BALL_MAGIC, 5, vga_ball_arg_t)
+/* One-shot flap: no argument; queues one flap in the hardware */
+#define VGA_BALL_FLAP _IO(VGA_BALL_MAGIC, 6)
+/* Returns (and stores in applied) the number of writes applied; stops
+   at the first write to a register other than BG, BALL, FLAP, COMMIT,
+   TILEMAP_ADDR, TILEMAP_DATA, SHEET_ADDR, SHEET_DATA, IMAGE(i), or the
+   SPRITE_POS and SPRITE_CTRL of a sprite the game does not own */
+#define VGA_BALL_WRITE_BATCH _IOWR(VGA_BALL_MAGIC, 7, vga_ball_batch_t)
+#define VGA_BALL_READ_STATE _IOR(VGA_BALL_MAGIC, 8, vga_ball_state_t)
+#define VGA_BALL_READ_TIME _IOR(VGA_BALL_MAGIC, 9, vga_ball_time_t)
+/* Copy the shadow registers to the active set.  The argument is
+   VGA_BALL_COMMIT_VSYNC (or 0) to wait for the next vsync, or
+   VGA_BALL_COMMIT_NOW (vga_ball_regs.h) */
+#define VGA_BALL_COMMIT _IO(VGA_BALL_MAGIC, 10)
+/* Argument is VGA_BALL_READ_FRAMES or VGA_BALL_READ_EVENTS.  Switching
+   to events starts with an empty queue. */
+#define VGA_BALL_SET_READ_MODE _IO(VGA_BALL_MAGIC, 11)
+/* Argument is a background number or VGA_BALL_BACKGROUND_TILES; the
+   change takes effect at the next vsync */
+#define VGA_BALL_SHOW_BACKGROUND _IO(VGA_BALL_MAGIC, 12)
+/* Position, frame and priority of one sprite, shown from the next row
+   drawn; fails for sprites 0 and 1 */
+#define VGA_BALL_WRITE_SPRITE _IOW(VGA_BALL_MAGIC, 13, vga_ball_sprite_t)
 
 #endif
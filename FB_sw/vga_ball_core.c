@@ -0,0 +1,520 @@
+/*
+ * Register-level core of the vga_ball driver
+ *
+ * Everything here goes through the registers alone, so the same code is
+ * built into vga_ball.ko and, against vga_ball_mock.c, into host
+ * programs such as vga_ball_bench.  See vga_ball_core.h.
+ */
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/io.h>
+#include <linux/uaccess.h>
+#endif
+#include "vga_ball_core.h"
+#include "vga_ball_regs.h"
+#ifdef __KERNEL__
+#include "vga_ball_trace.h" /* Defined in vga_ball_drv.c */
+#endif
+
+/*
+ * ioctl commands we count, indexed by their _IOC_NR
+ */
+const struct vga_ball_cmd vga_ball_cmds[VGA_BALL_NR_CMDS] = {
+	[_IOC_NR(VGA_BALL_WRITE_BACKGROUND)] = { VGA_BALL_WRITE_BACKGROUND,
+						 "write_background" },
+	[_IOC_NR(VGA_BALL_READ_BACKGROUND)] = { VGA_BALL_READ_BACKGROUND,
+						"read_background" },
+	[_IOC_NR(VGA_BALL_WRITE_BALL)] = { VGA_BALL_WRITE_BALL, "write_ball" },
+	[_IOC_NR(VGA_BALL_READ_BALL)] = { VGA_BALL_READ_BALL, "read_ball" },
+	[_IOC_NR(VGA_BALL_WRITE_FLAP)] = { VGA_BALL_WRITE_FLAP, "write_flap" },
+	[_IOC_NR(VGA_BALL_FLAP)] = { VGA_BALL_FLAP, "flap" },
+	[_IOC_NR(VGA_BALL_WRITE_BATCH)] = { VGA_BALL_WRITE_BATCH,
+					    "write_batch" },
+	[_IOC_NR(VGA_BALL_READ_STATE)] = { VGA_BALL_READ_STATE, "read_state" },
+	[_IOC_NR(VGA_BALL_READ_TIME)] = { VGA_BALL_READ_TIME, "read_time" },
+	[_IOC_NR(VGA_BALL_COMMIT)] = { VGA_BALL_COMMIT, "commit" },
+	[_IOC_NR(VGA_BALL_SET_READ_MODE)] = { VGA_BALL_SET_READ_MODE,
+					      "set_read_mode" },
+	[_IOC_NR(VGA_BALL_SHOW_BACKGROUND)] = { VGA_BALL_SHOW_BACKGROUND,
+						"show_background" },
+	[_IOC_NR(VGA_BALL_WRITE_SPRITE)] = { VGA_BALL_WRITE_SPRITE,
+					     "write_sprite" },
+};
+
+/*
+ * Set up the register state of a device whose registers are at virtbase.
+ * core must be zeroed: nothing is known about the hardware yet.
+ */
+void vga_ball_core_init(struct vga_ball_core *core, void __iomem *virtbase)
+{
+	spin_lock_init(&core->reg_lock);
+	core->virtbase = virtbase;
+}
+
+/*
+ * Copy the shadow display registers to the active set, at the next
+ * vsync (VGA_BALL_COMMIT_VSYNC) or at once (VGA_BALL_COMMIT_NOW).
+ * Called with reg_lock held, as are the two below.
+ */
+static void write_commit(struct vga_ball_core *core, unsigned char flags)
+{
+	iowrite32(flags, core->virtbase + VGA_BALL_REG_COMMIT);
+	atomic_long_inc(&core->reg_writes);
+	core->uncommitted = false;
+}
+
+/*
+ * Write BG or BALL unless the hardware already holds that value.  Each
+ * write is an uncached trip across the lightweight bridge, and software
+ * that pushes its whole state every frame mostly repeats itself.
+ */
+static void write_shadow(struct vga_ball_core *core, unsigned int reg,
+			 u32 value)
+{
+	unsigned int i = reg / 4;
+	bool queued = atomic_read(&core->cmds_pending);
+
+	if ((core->shadow_valid & (1 << i)) && core->shadow[i] == value &&
+	    !atomic_read(&core->mappings) && !queued) {
+		atomic_long_inc(&core->elided_writes);
+		return;
+	}
+	iowrite32(value, core->virtbase + reg);
+	atomic_long_inc(&core->reg_writes);
+	core->shadow[i] = value;
+	if (queued)	/* A queued command may still overwrite it */
+		core->shadow_valid &= ~(1 << i);
+	else
+		core->shadow_valid |= 1 << i;
+	core->uncommitted = true;
+}
+
+/*
+ * Show what write_shadow() wrote at the next vsync, if anything changed
+ */
+static void commit_changes(struct vga_ball_core *core)
+{
+	if (core->uncommitted)
+		write_commit(core, VGA_BALL_COMMIT_VSYNC);
+	else
+		atomic_long_inc(&core->elided_writes);
+}
+
+/*
+ * Commit whether or not anything changed
+ */
+void vga_ball_commit(struct vga_ball_core *core, unsigned char flags)
+{
+	spin_lock(&core->reg_lock);
+	write_commit(core, flags);
+	spin_unlock(&core->reg_lock);
+}
+
+/*
+ * Something other than write_shadow() changed BG or BALL, so stop
+ * trusting shadow[]
+ */
+void vga_ball_forget_shadow(struct vga_ball_core *core)
+{
+	spin_lock(&core->reg_lock);
+	core->shadow_valid = 0;
+	spin_unlock(&core->reg_lock);
+}
+
+/*
+ * Commands were just pushed to the hardware FIFO.  CMD_SET_BG and
+ * CMD_SET_BALL run at the next frame, bypassing write_shadow(), so
+ * shadow[] cannot be trusted until vga_ball_check_cmds() sees the FIFO
+ * empty.  Reading CMD_LEVEL first makes sure the pushes have reached
+ * the FIFO before the interrupt can look at it.
+ */
+void vga_ball_cmds_queued(struct vga_ball_core *core)
+{
+	ioread32(core->virtbase + VGA_BALL_REG_CMD_LEVEL);
+	atomic_inc(&core->cmds_pending);
+	vga_ball_forget_shadow(core);
+}
+
+/*
+ * Called from the vsync interrupt: once the FIFO has drained, trust
+ * shadow[] again.  If more commands were queued since we looked,
+ * cmds_pending has moved on and stays set.
+ */
+void vga_ball_check_cmds(struct vga_ball_core *core)
+{
+	int pending = atomic_read(&core->cmds_pending);
+
+	if (pending &&
+	    ioread32(core->virtbase + VGA_BALL_REG_CMD_LEVEL) == 0)
+		atomic_cmpxchg(&core->cmds_pending, pending, 0);
+}
+
+/*
+ * Write segments of a single digit
+ * Assumes digit is in range and the device information has been set up
+ * The registers are double-buffered, so the new color appears all at
+ * once at the next vsync
+ */
+void vga_ball_write_background(struct vga_ball_core *core,
+			       vga_ball_color_t *background)
+{
+	spin_lock(&core->reg_lock);
+	write_shadow(core, VGA_BALL_REG_BG,
+		     VGA_BALL_BG(background->red, background->green,
+				 background->blue));
+	commit_changes(core);
+	core->background = *background;
+	spin_unlock(&core->reg_lock);
+	trace_vga_ball_background(background);
+}
+
+void vga_ball_write_ball_position(struct vga_ball_core *core,
+				  vga_ball_position_t *ball)
+{
+    spin_lock(&core->reg_lock);
+
+    // X and Y go out in one bus write, if they changed
+    write_shadow(core, VGA_BALL_REG_BALL, VGA_BALL_XY(ball->x, ball->y));
+
+    // Radius is not used: the hardware draws the ball at a fixed size
+
+    // The write lands in the shadow registers; show it at the next vsync
+    commit_changes(core);
+
+    core->ball = *ball;
+    spin_unlock(&core->reg_lock);
+    trace_vga_ball_ball(ball);
+}
+
+/*
+ * Write the flap signal
+ */
+void vga_ball_write_flap(struct vga_ball_core *core, unsigned char flap)
+{
+    // Ensure value is either 0 or 1
+    unsigned char value = flap ? 1 : 0;
+    
+    // Write to the flap register
+    spin_lock(&core->reg_lock);
+    iowrite32(value, core->virtbase + VGA_BALL_REG_FLAP);
+    
+    // Store in device structure
+    core->flap = value;
+    spin_unlock(&core->reg_lock);
+    
+    // Tracepoint instead of printk: costs nothing unless enabled
+    trace_vga_ball_flap(value);
+}
+
+/*
+ * Write a single register and keep our copy of the device state in step
+ */
+static void write_reg(struct vga_ball_core *core, unsigned int reg,
+		      u32 value)
+{
+	spin_lock(&core->reg_lock);
+
+	switch (reg) {
+	case VGA_BALL_REG_COMMIT:
+		write_commit(core, value);
+		break;
+	case VGA_BALL_REG_FLAP:
+		/* Every flap write counts, so it is never elided */
+		iowrite32(value, core->virtbase + reg);
+		core->flap = value & 1;
+		break;
+	case VGA_BALL_REG_BG:
+		write_shadow(core, reg, value);
+		core->background.red = value & 0xff;
+		core->background.green = (value >> 8) & 0xff;
+		core->background.blue = (value >> 16) & 0xff;
+		break;
+	case VGA_BALL_REG_BALL:
+		write_shadow(core, reg, value);
+		core->ball.x = value & 0x3ff;
+		core->ball.y = (value >> 16) & 0x3ff;
+		break;
+	default:
+		/* Tile map, sprite sheet and sprite tables: not shadowed */
+		iowrite32(value, core->virtbase + reg);
+		break;
+	}
+	spin_unlock(&core->reg_lock);
+
+	if (reg == VGA_BALL_REG_FLAP)
+		trace_vga_ball_flap(value & 1);
+}
+
+#define BATCH_CHUNK 32 /* Writes copied from userspace at a time */
+
+/*
+ * Registers userspace may write through VGA_BALL_WRITE_BATCH
+ */
+static bool writable_reg(unsigned int reg)
+{
+	if (reg % 4)
+		return false;
+	if (reg == VGA_BALL_REG_COMMIT || reg == VGA_BALL_REG_TILEMAP_ADDR ||
+	    reg == VGA_BALL_REG_TILEMAP_DATA ||
+	    reg == VGA_BALL_REG_SHEET_ADDR || reg == VGA_BALL_REG_SHEET_DATA)
+		return true;
+	if (reg >= VGA_BALL_REG_SPRITE_POS(VGA_BALL_HW_SPRITES) &&
+	    reg < VGA_BALL_REG_SPRITE_POS(VGA_BALL_SPRITES))
+		return true;
+	if (reg >= VGA_BALL_REG_IMAGE(0) &&
+	    reg < VGA_BALL_REG_IMAGE(VGA_BALL_IMAGES))
+		return true;
+	return reg < 4 * VGA_BALL_NUM_DISPLAY_REGS;
+}
+
+/*
+ * Apply a user array of register writes in order.
+ * Returns the number applied, or a negative error if none were.
+ */
+static long write_batch(struct vga_ball_core *core,
+			vga_ball_batch_t __user *ubatch)
+{
+	vga_ball_write_t chunk[BATCH_CHUNK];
+	vga_ball_write_t __user *writes;
+	vga_ball_batch_t batch;
+	unsigned int applied = 0, n, i;
+	long ret = 0;
+
+	if (copy_from_user(&batch, ubatch, sizeof(batch)))
+		return -EACCES;
+	writes = u64_to_user_ptr(batch.writes);
+
+	while (applied < batch.count) {
+		n = min_t(unsigned int, batch.count - applied, BATCH_CHUNK);
+		if (copy_from_user(chunk, writes + applied,
+				   n * sizeof(vga_ball_write_t))) {
+			ret = -EACCES;
+			break;
+		}
+		for (i = 0; i < n; i++) {
+			if (!writable_reg(chunk[i].reg)) {
+				ret = -EINVAL;
+				break;
+			}
+			write_reg(core, chunk[i].reg, chunk[i].value);
+			applied++;
+		}
+		if (ret)
+			break;
+	}
+
+	if (put_user(applied, &ubatch->applied))
+		return -EACCES;
+	return applied || !ret ? applied : ret;
+}
+
+/*
+ * Read the live game state.  The read of STATUS makes the hardware take
+ * the snapshot that the remaining reads return.
+ */
+void vga_ball_read_state(struct vga_ball_core *core,
+			 vga_ball_state_t *state)
+{
+	void __iomem *base = core->virtbase;
+	u32 v;
+	int i;
+
+	spin_lock(&core->reg_lock);
+	v = ioread32(base + VGA_BALL_REG_STATUS);
+	state->score = VGA_BALL_STATUS_SCORE(v);
+	state->game_state = VGA_BALL_STATUS_GAME_STATE(v);
+	state->flap_pending = VGA_BALL_STATUS_FLAP_PENDING(v);
+	state->bird_y = ioread32(base + VGA_BALL_REG_BIRD_Y);
+	v = ioread32(base + VGA_BALL_REG_FLAP_COUNTS);
+	state->flaps_received = VGA_BALL_LO(v);
+	state->flaps_dropped = VGA_BALL_HI(v);
+	for (i = 0; i < VGA_BALL_PIPES; i++) {
+		v = ioread32(base + VGA_BALL_REG_PIPE(i));
+		state->pipes[i].x = VGA_BALL_LO(v);
+		state->pipes[i].gap_y = VGA_BALL_HI(v);
+	}
+	spin_unlock(&core->reg_lock);
+}
+
+/*
+ * Read the hardware counters.  The read of FRAME makes the hardware
+ * take the snapshot that the remaining reads return.
+ */
+void vga_ball_read_time(struct vga_ball_core *core, vga_ball_time_t *time)
+{
+	void __iomem *base = core->virtbase;
+	u32 lo, hi;
+
+	spin_lock(&core->reg_lock);
+	time->frame = ioread32(base + VGA_BALL_REG_FRAME);
+	time->vsync_cycles = ioread32(base + VGA_BALL_REG_VSYNC_CYCLES);
+	lo = ioread32(base + VGA_BALL_REG_CYCLES);
+	hi = ioread32(base + VGA_BALL_REG_CYCLES + 4);
+	spin_unlock(&core->reg_lock);
+	time->cycles = (u64)hi << 32 | lo;
+}
+
+/*
+ * Point the background DMA at one of the driver's buffers, or go back
+ * to the tiles.  The hardware switches at the next vsync.
+ */
+static long show_background(struct vga_ball_core *core, unsigned long bg)
+{
+	if (bg != VGA_BALL_BACKGROUND_TILES && bg >= core->backgrounds)
+		return -EINVAL;
+
+	spin_lock(&core->reg_lock);
+	if (bg == VGA_BALL_BACKGROUND_TILES) {
+		iowrite32(0, core->virtbase + VGA_BALL_REG_DMA_CTRL);
+	} else {
+		iowrite32(core->background_dma[bg],
+			  core->virtbase + VGA_BALL_REG_DMA_BASE);
+		iowrite32(VGA_BALL_DMA_ENABLE,
+			  core->virtbase + VGA_BALL_REG_DMA_CTRL);
+	}
+	spin_unlock(&core->reg_lock);
+	return 0;
+}
+
+/*
+ * Place one of the sprites software owns
+ */
+static long write_sprite(struct vga_ball_core *core,
+			 const vga_ball_sprite_t *sprite)
+{
+	u32 ctrl;
+
+	if (sprite->index < VGA_BALL_HW_SPRITES ||
+	    sprite->index >= VGA_BALL_SPRITES ||
+	    sprite->frame >= VGA_BALL_IMAGES || sprite->priority > 3 ||
+	    sprite->x < -1024 || sprite->x > 1023 ||
+	    sprite->y < -1024 || sprite->y > 1023)
+		return -EINVAL;
+
+	ctrl = VGA_BALL_SPRITE_CTRL(sprite->priority, sprite->frame);
+	if (!sprite->enable)
+		ctrl &= ~VGA_BALL_SPRITE_ENABLE;
+
+	spin_lock(&core->reg_lock);
+	iowrite32(VGA_BALL_SPRITE_XY(sprite->x, sprite->y),
+		  core->virtbase + VGA_BALL_REG_SPRITE_POS(sprite->index));
+	iowrite32(ctrl,
+		  core->virtbase + VGA_BALL_REG_SPRITE_CTRL(sprite->index));
+	spin_unlock(&core->reg_lock);
+	return 0;
+}
+
+/*
+ * Count one ioctl call, by command
+ */
+void vga_ball_count_cmd(struct vga_ball_core *core, unsigned int cmd)
+{
+	unsigned int nr = _IOC_NR(cmd);
+
+	if (nr < ARRAY_SIZE(vga_ball_cmds) && vga_ball_cmds[nr].cmd == cmd)
+		atomic_long_inc(&core->cmd_count[nr]);
+	else
+		atomic_long_inc(&core->bad_cmd_count);
+}
+
+/*
+ * The ioctl commands that only need the registers; the caller handles
+ * the ones that need an open file.  Counts every command it is given.
+ */
+long vga_ball_core_ioctl(struct vga_ball_core *core, unsigned int cmd,
+			 unsigned long arg)
+{
+	vga_ball_arg_t vla;
+	vga_ball_state_t state;
+	vga_ball_time_t time;
+	vga_ball_sprite_t sprite;
+
+	vga_ball_count_cmd(core, cmd);
+
+	switch (cmd) {
+	case VGA_BALL_WRITE_BACKGROUND:
+		if (copy_from_user(&vla, (vga_ball_arg_t *) arg,
+				   sizeof(vga_ball_arg_t)))
+			return -EACCES;
+		vga_ball_write_background(core, &vla.background);
+		break;
+
+	case VGA_BALL_READ_BACKGROUND:
+		spin_lock(&core->reg_lock);
+	  	vla.background = core->background;
+		spin_unlock(&core->reg_lock);
+		if (copy_to_user((vga_ball_arg_t *) arg, &vla,
+				 sizeof(vga_ball_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_BALL_WRITE_BALL:
+		if (copy_from_user(&vla, (vga_ball_arg_t *) arg,
+		           sizeof(vga_ball_arg_t)))
+		    return -EACCES;
+		vga_ball_write_ball_position(core, &vla.ball);
+		break;
+
+	case VGA_BALL_READ_BALL:
+		spin_lock(&core->reg_lock);
+		vla.ball = core->ball;
+		spin_unlock(&core->reg_lock);
+		if (copy_to_user((vga_ball_arg_t *) arg, &vla,
+		         sizeof(vga_ball_arg_t)))
+		    return -EACCES;
+		break;
+
+	case VGA_BALL_WRITE_FLAP:
+		if (copy_from_user(&vla, (vga_ball_arg_t *) arg, sizeof(vga_ball_arg_t)))
+		    return -EACCES;
+		
+		// Use the helper function for consistency
+		vga_ball_write_flap(core, vla.flap);
+		break;
+
+	case VGA_BALL_FLAP:
+		/* vga_ball.sv queues it and applies it at the next tick */
+		vga_ball_write_flap(core, 1);
+		break;
+
+	case VGA_BALL_WRITE_BATCH:
+		return write_batch(core, (vga_ball_batch_t __user *) arg);
+
+	case VGA_BALL_READ_STATE:
+		vga_ball_read_state(core, &state);
+		if (copy_to_user((vga_ball_state_t *) arg, &state,
+				 sizeof(vga_ball_state_t)))
+			return -EACCES;
+		break;
+
+	case VGA_BALL_READ_TIME:
+		vga_ball_read_time(core, &time);
+		if (copy_to_user((vga_ball_time_t *) arg, &time,
+				 sizeof(vga_ball_time_t)))
+			return -EACCES;
+		break;
+
+	case VGA_BALL_COMMIT:
+		if (arg & ~(unsigned long)(VGA_BALL_COMMIT_VSYNC |
+					   VGA_BALL_COMMIT_NOW))
+			return -EINVAL;
+		/* Asked for explicitly, so never elided */
+		vga_ball_commit(core, arg ? arg : VGA_BALL_COMMIT_VSYNC);
+		break;
+
+	case VGA_BALL_SHOW_BACKGROUND:
+		return show_background(core, arg);
+
+	case VGA_BALL_WRITE_SPRITE:
+		if (copy_from_user(&sprite, (vga_ball_sprite_t *) arg,
+				   sizeof(vga_ball_sprite_t)))
+			return -EACCES;
+		return write_sprite(core, &sprite);
+
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef _VGA_BALL_CORE_H
+#define _VGA_BALL_CORE_H
+
+/*
+ * The part of the vga_ball driver that only talks to the registers:
+ * the shadowed writes, the state reads and the ioctl commands built on
+ * them.  vga_ball_drv.c wraps it in a platform/misc device; built
+ * without __KERNEL__ it runs on vga_ball_mock.h's fake registers so it
+ * can be exercised and timed on the host.
+ */
+
+#ifdef __KERNEL__
+#include <linux/types.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+#else
+#include "vga_ball_mock.h"
+#endif
+#include "vga_ball.h"
+
+#define VGA_BALL_NR_CMDS 14 /* One past the highest ioctl _IOC_NR */
+
+/*
+ * ioctl commands we count, indexed by their _IOC_NR
+ */
+struct vga_ball_cmd {
+	unsigned int cmd;
+	const char *name;
+};
+extern const struct vga_ball_cmd vga_ball_cmds[VGA_BALL_NR_CMDS];
+
+/*
+ * Register state of one device
+ */
+struct vga_ball_core {
+	void __iomem *virtbase; /* Where registers can be accessed in memory */
+	spinlock_t reg_lock; /* Register sequences and the copies below */
+	vga_ball_color_t background;
+	vga_ball_position_t ball;
+	unsigned char flap;
+	u32 shadow[2]; /* Last BG and BALL words written to the hardware */
+	unsigned int shadow_valid; /* Bit per shadow[] entry we know */
+	bool uncommitted; /* shadow[] changed since the last commit */
+	atomic_t mappings; /* mmap()s of the registers; they bypass shadow[] */
+	atomic_t cmds_pending; /* Nonzero while FIFO commands may run */
+	atomic_long_t reg_writes; /* BG, BALL and COMMIT writes issued */
+	atomic_long_t elided_writes; /* ... and skipped as redundant */
+	atomic_long_t cmd_count[VGA_BALL_NR_CMDS];
+	atomic_long_t bad_cmd_count; /* ioctls we did not recognize */
+	u32 background_dma[VGA_BALL_BACKGROUNDS]; /* Of the DMA backgrounds */
+	unsigned int backgrounds; /* How many the driver could allocate */
+};
+
+void vga_ball_core_init(struct vga_ball_core *core, void __iomem *virtbase);
+void vga_ball_write_background(struct vga_ball_core *core,
+			       vga_ball_color_t *background);
+void vga_ball_write_ball_position(struct vga_ball_core *core,
+				  vga_ball_position_t *ball);
+void vga_ball_write_flap(struct vga_ball_core *core, unsigned char flap);
+void vga_ball_commit(struct vga_ball_core *core, unsigned char flags);
+void vga_ball_forget_shadow(struct vga_ball_core *core);
+void vga_ball_cmds_queued(struct vga_ball_core *core);
+void vga_ball_check_cmds(struct vga_ball_core *core);
+void vga_ball_read_state(struct vga_ball_core *core, vga_ball_state_t *state);
+void vga_ball_read_time(struct vga_ball_core *core, vga_ball_time_t *time);
+void vga_ball_count_cmd(struct vga_ball_core *core, unsigned int cmd);
+long vga_ball_core_ioctl(struct vga_ball_core *core, unsigned int cmd,
+			 unsigned long arg);
+
+#endif /* _VGA_BALL_CORE_H */
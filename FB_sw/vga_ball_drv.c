@@ -0,0 +1,845 @@
+/* * Device driver for the VGA video generator
+ *
+ * A Platform device implemented using the misc subsystem
+ *
+ * Stephen A. Edwards
+ * Columbia University
+ *
+ * References:
+ * Linux source: Documentation/driver-model/platform.txt
+ *               drivers/misc/arm-charlcd.c
+ * http://www.linuxforu.com/tag/linux-device-drivers/
+ * http://free-electrons.com/docs/
+ *
+ * "make" to build
+ * insmod vga_ball.ko
+ *
+ * Check code style with
+ * checkpatch.pl --file --no-tree vga_ball_drv.c vga_ball_core.c
+ */
+
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/errno.h>
+#include <linux/version.h>
+#include <linux/kernel.h>
+#include <linux/platform_device.h>
+#include <linux/miscdevice.h>
+#include <linux/slab.h>
+#include <linux/io.h>
+#include <linux/of.h>
+#include <linux/of_address.h>
+#include <linux/fs.h>
+#include <linux/uaccess.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/atomic.h>
+#include <linux/mm.h>
+#include <linux/interrupt.h>
+#include <linux/of_irq.h>
+#include <linux/poll.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+#include <linux/ktime.h>
+#include <linux/mutex.h>
+#include <linux/jiffies.h>
+#include <linux/kfifo.h>
+#include <linux/list.h>
+#include <linux/idr.h>
+#include <linux/dma-mapping.h>
+#include <linux/delay.h>
+#include "vga_ball.h"
+#include "vga_ball_regs.h"
+#include "vga_ball_core.h"
+
+#define CREATE_TRACE_POINTS
+#include "vga_ball_trace.h"
+
+#define DRIVER_NAME "vga_ball"
+
+/* Device registers (32 bits each) */
+#define IRQ_ENABLE(x) ((x)+VGA_BALL_REG_IRQ_ENABLE)
+#define IRQ_ACK(x) ((x)+VGA_BALL_REG_IRQ_ACK)
+#define CMD_FIFO(x) ((x)+VGA_BALL_REG_CMD_FIFO)
+#define CMD_LEVEL(x) ((x)+VGA_BALL_REG_CMD_LEVEL)
+#define CMD_OVERFLOWS(x) ((x)+VGA_BALL_REG_CMD_OVERFLOWS)
+#define EVENTS(x) ((x)+VGA_BALL_REG_EVENTS)
+#define DMA_CTRL(x) ((x)+VGA_BALL_REG_DMA_CTRL)
+#define DMA_UNDERRUNS(x) ((x)+VGA_BALL_REG_DMA_UNDERRUNS)
+#define DMA_BUSY(x) ((x)+VGA_BALL_REG_DMA_BUSY)
+#define SPRITE_DROPS(x) ((x)+VGA_BALL_REG_SPRITE_DROPS)
+
+#define EVENT_QUEUE 64 /* Events each open file can hold; a power of 2 */
+
+/*
+ * Information about one of our devices; each device tree node gets its own
+ */
+struct vga_ball_dev {
+	struct miscdevice misc; /* /dev/vga_ball, /dev/vga_ball1, ... */
+	int id; /* From vga_ball_ida; 0 is plain "vga_ball" */
+	char name[16];
+	struct resource res; /* Resource: our registers */
+	struct vga_ball_core core; /* The registers and what we wrote there */
+	void *background[VGA_BALL_BACKGROUNDS]; /* Read by the hardware's DMA */
+	dma_addr_t background_dma[VGA_BALL_BACKGROUNDS];
+	struct dentry *debugfs; /* debugfs directory with our counters */
+	int irq; /* Vsync interrupt, or 0 if the device tree has none */
+	spinlock_t frame_lock; /* Protects frame, frame_time and files */
+	u32 frame; /* Vsync interrupts seen */
+	ktime_t frame_time; /* When the last one arrived */
+	wait_queue_head_t frame_wait; /* Readers waiting for the next frame */
+	struct mutex cmd_lock; /* Serializes writers of the command FIFO */
+	atomic_long_t cmds_queued; /* Commands pushed by write() */
+	struct list_head files; /* Open files, for event delivery */
+	atomic_long_t events; /* Game events seen */
+	atomic_long_t events_dropped; /* Lost to a full per-file queue */
+};
+
+static DEFINE_IDA(vga_ball_ida);
+
+static struct vga_ball_dev *to_vga_ball_dev(struct miscdevice *misc)
+{
+	return container_of(misc, struct vga_ball_dev, misc);
+}
+
+/*
+ * What each open file has seen
+ */
+struct vga_ball_file {
+	struct vga_ball_dev *dev; /* The device it opened */
+	u32 last_frame; /* Last frame returned by read() */
+	int read_mode; /* VGA_BALL_READ_FRAMES or VGA_BALL_READ_EVENTS */
+	struct list_head node; /* On dev->files */
+	struct mutex read_lock; /* One reader of events at a time */
+	DECLARE_KFIFO(events, vga_ball_event_t, EVENT_QUEUE);
+};
+
+/*
+ * sysfs attributes of /dev/vga_ball (under /sys/class/misc/vga_ball)
+ * with the live score, bird position and game state.  The misc class
+ * device's driver data is our miscdevice.
+ */
+static struct vga_ball_dev *attr_dev(struct device *d)
+{
+	return to_vga_ball_dev(dev_get_drvdata(d));
+}
+
+static ssize_t score_show(struct device *d, struct device_attribute *attr,
+			  char *buf)
+{
+	vga_ball_state_t state;
+
+	vga_ball_read_state(&attr_dev(d)->core, &state);
+	return sprintf(buf, "%u\n", state.score);
+}
+static DEVICE_ATTR_RO(score);
+
+static ssize_t bird_y_show(struct device *d, struct device_attribute *attr,
+			   char *buf)
+{
+	vga_ball_state_t state;
+
+	vga_ball_read_state(&attr_dev(d)->core, &state);
+	return sprintf(buf, "%u\n", state.bird_y);
+}
+static DEVICE_ATTR_RO(bird_y);
+
+static ssize_t game_state_show(struct device *d,
+			       struct device_attribute *attr, char *buf)
+{
+	static const char * const names[] = {
+		[VGA_BALL_STATE_WAITING] = "waiting",
+		[VGA_BALL_STATE_PLAYING] = "playing",
+		[VGA_BALL_STATE_GAME_OVER] = "game_over",
+	};
+	vga_ball_state_t state;
+
+	vga_ball_read_state(&attr_dev(d)->core, &state);
+	if (state.game_state < ARRAY_SIZE(names))
+		return sprintf(buf, "%s\n", names[state.game_state]);
+	return sprintf(buf, "%u\n", state.game_state);
+}
+static DEVICE_ATTR_RO(game_state);
+
+static ssize_t flaps_received_show(struct device *d,
+				   struct device_attribute *attr, char *buf)
+{
+	vga_ball_state_t state;
+
+	vga_ball_read_state(&attr_dev(d)->core, &state);
+	return sprintf(buf, "%u\n", state.flaps_received);
+}
+static DEVICE_ATTR_RO(flaps_received);
+
+static ssize_t flaps_dropped_show(struct device *d,
+				  struct device_attribute *attr, char *buf)
+{
+	vga_ball_state_t state;
+
+	vga_ball_read_state(&attr_dev(d)->core, &state);
+	return sprintf(buf, "%u\n", state.flaps_dropped);
+}
+static DEVICE_ATTR_RO(flaps_dropped);
+
+static ssize_t frame_show(struct device *d, struct device_attribute *attr,
+			  char *buf)
+{
+	vga_ball_time_t time;
+
+	vga_ball_read_time(&attr_dev(d)->core, &time);
+	return sprintf(buf, "%u\n", time.frame);
+}
+static DEVICE_ATTR_RO(frame);
+
+static struct attribute *vga_ball_attrs[] = {
+	&dev_attr_score.attr,
+	&dev_attr_bird_y.attr,
+	&dev_attr_game_state.attr,
+	&dev_attr_flaps_received.attr,
+	&dev_attr_flaps_dropped.attr,
+	&dev_attr_frame.attr,
+	NULL,
+};
+ATTRIBUTE_GROUPS(vga_ball);
+
+/*
+ * debugfs "counters": one "name count" line per ioctl command
+ */
+static int counters_show(struct seq_file *s, void *unused)
+{
+	struct vga_ball_dev *dev = s->private;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(vga_ball_cmds); i++)
+		if (vga_ball_cmds[i].name)
+			seq_printf(s, "%s %ld\n", vga_ball_cmds[i].name,
+				   atomic_long_read(&dev->core.cmd_count[i]));
+	seq_printf(s, "invalid %ld\n", atomic_long_read(&dev->core.bad_cmd_count));
+	seq_printf(s, "reg_writes %ld\n",
+		   atomic_long_read(&dev->core.reg_writes));
+	seq_printf(s, "elided_writes %ld\n",
+		   atomic_long_read(&dev->core.elided_writes));
+	seq_printf(s, "cmds_queued %ld\n", atomic_long_read(&dev->cmds_queued));
+	seq_printf(s, "cmd_level %u\n", ioread32(CMD_LEVEL(dev->core.virtbase)));
+	seq_printf(s, "cmd_overflows %u\n",
+		   ioread32(CMD_OVERFLOWS(dev->core.virtbase)));
+	seq_printf(s, "events %ld\n", atomic_long_read(&dev->events));
+	seq_printf(s, "events_dropped %ld\n",
+		   atomic_long_read(&dev->events_dropped));
+	seq_printf(s, "dma_underruns %u\n",
+		   ioread32(DMA_UNDERRUNS(dev->core.virtbase)));
+	seq_printf(s, "sprite_drops %u\n",
+		   ioread32(SPRITE_DROPS(dev->core.virtbase)));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(counters);
+
+/*
+ * Choose what read() returns on this file.  Entering event mode starts
+ * from an empty queue.
+ */
+static long set_read_mode(struct vga_ball_file *vf, unsigned long mode)
+{
+	struct vga_ball_dev *dev = vf->dev;
+	unsigned long flags;
+
+	if (mode != VGA_BALL_READ_FRAMES && mode != VGA_BALL_READ_EVENTS)
+		return -EINVAL;
+
+	mutex_lock(&vf->read_lock);
+	spin_lock_irqsave(&dev->frame_lock, flags);
+	if (mode == VGA_BALL_READ_EVENTS && vf->read_mode != mode)
+		kfifo_reset(&vf->events);
+	vf->read_mode = mode;
+	vf->last_frame = dev->frame;
+	spin_unlock_irqrestore(&dev->frame_lock, flags);
+	mutex_unlock(&vf->read_lock);
+	return 0;
+}
+
+/*
+ * Handle ioctl() calls from userspace:
+ * Read or write the segments on single digits.
+ * Note extensive error checking of arguments
+ */
+static long vga_ball_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
+{
+	struct vga_ball_file *vf = f->private_data;
+
+	/* The only command that needs the open file */
+	if (cmd == VGA_BALL_SET_READ_MODE) {
+		vga_ball_count_cmd(&vf->dev->core, cmd);
+		return set_read_mode(vf, arg);
+	}
+	return vga_ball_core_ioctl(&vf->dev->core, cmd, arg);
+}
+
+/*
+ * Give each file in event mode one record per flag in the hardware's
+ * EVENTS word.  Called with frame_lock held, from the interrupt.
+ */
+static void queue_events(struct vga_ball_dev *dev, u32 events)
+{
+	struct vga_ball_file *vf;
+	vga_ball_event_t e = {
+		.frame = dev->frame,
+		.timestamp = ktime_to_ns(dev->frame_time),
+		.score = VGA_BALL_EVENTS_SCORE(events),
+		.game_state = VGA_BALL_EVENTS_GAME_STATE(events),
+	};
+
+	for (e.type = 0; e.type < VGA_BALL_EVENTS; e.type++) {
+		if (!(VGA_BALL_EVENTS_FLAGS(events) & (1 << e.type)))
+			continue;
+		atomic_long_inc(&dev->events);
+		list_for_each_entry(vf, &dev->files, node)
+			if (vf->read_mode == VGA_BALL_READ_EVENTS &&
+			    !kfifo_put(&vf->events, e))
+				atomic_long_inc(&dev->events_dropped);
+	}
+}
+
+/*
+ * Vsync interrupt: acknowledge it, note the frame and any game events,
+ * and wake up readers
+ */
+static irqreturn_t vga_ball_irq(int irq, void *data)
+{
+	struct vga_ball_dev *dev = data;
+	u32 events;
+
+	iowrite32(1, IRQ_ACK(dev->core.virtbase));
+	events = ioread32(EVENTS(dev->core.virtbase));
+	vga_ball_check_cmds(&dev->core);
+
+	spin_lock(&dev->frame_lock);
+	dev->frame++;
+	dev->frame_time = ktime_get();
+	if (VGA_BALL_EVENTS_FLAGS(events))
+		queue_events(dev, events);
+	spin_unlock(&dev->frame_lock);
+
+	wake_up_interruptible(&dev->frame_wait);
+	return IRQ_HANDLED;
+}
+
+static int vga_ball_open(struct inode *inode, struct file *f)
+{
+	/* misc_open() left our miscdevice in private_data */
+	struct vga_ball_dev *dev = to_vga_ball_dev(f->private_data);
+	struct vga_ball_file *vf = kzalloc(sizeof(*vf), GFP_KERNEL);
+	unsigned long flags;
+
+	if (!vf)
+		return -ENOMEM;
+	vf->dev = dev;
+	INIT_KFIFO(vf->events);
+	mutex_init(&vf->read_lock);
+	vf->read_mode = VGA_BALL_READ_FRAMES;
+
+	spin_lock_irqsave(&dev->frame_lock, flags);
+	/* The first read() waits for the frame after this one */
+	vf->last_frame = dev->frame;
+	list_add_tail(&vf->node, &dev->files);
+	spin_unlock_irqrestore(&dev->frame_lock, flags);
+
+	f->private_data = vf;
+	return 0;
+}
+
+static int vga_ball_release(struct inode *inode, struct file *f)
+{
+	struct vga_ball_file *vf = f->private_data;
+	struct vga_ball_dev *dev = vf->dev;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->frame_lock, flags);
+	list_del(&vf->node);
+	spin_unlock_irqrestore(&dev->frame_lock, flags);
+	kfree(vf);
+	return 0;
+}
+
+/*
+ * read() in event mode: as many whole vga_ball_event_t records as fit,
+ * blocking until there is at least one
+ */
+static ssize_t read_events(struct vga_ball_file *vf, struct file *f,
+			   char __user *buf, size_t count)
+{
+	struct vga_ball_dev *dev = vf->dev;
+	unsigned int copied;
+	int ret;
+
+	if (count < sizeof(vga_ball_event_t))
+		return -EINVAL;
+
+	if (mutex_lock_interruptible(&vf->read_lock))
+		return -ERESTARTSYS;
+	while (kfifo_is_empty(&vf->events)) {
+		mutex_unlock(&vf->read_lock);
+		if (f->f_flags & O_NONBLOCK)
+			return -EAGAIN;
+		ret = wait_event_interruptible(dev->frame_wait,
+				!kfifo_is_empty(&vf->events));
+		if (ret)
+			return ret;
+		if (mutex_lock_interruptible(&vf->read_lock))
+			return -ERESTARTSYS;
+	}
+
+	ret = kfifo_to_user(&vf->events, buf,
+			    rounddown(count, sizeof(vga_ball_event_t)),
+			    &copied);
+	mutex_unlock(&vf->read_lock);
+	return ret ? ret : copied;
+}
+
+/*
+ * read() blocks until a frame this file has not seen yet starts and
+ * returns its vga_ball_frame_t.  If several frames went by, only the
+ * latest is returned; the gap shows in the frame numbers.  Files in
+ * VGA_BALL_READ_EVENTS mode get game events instead (read_events()).
+ */
+static ssize_t vga_ball_read(struct file *f, char __user *buf, size_t count,
+			     loff_t *offp)
+{
+	struct vga_ball_file *vf = f->private_data;
+	struct vga_ball_dev *dev = vf->dev;
+	vga_ball_frame_t frame = { 0 };
+	unsigned long flags;
+	int ret;
+
+	if (!dev->irq)
+		return -ENODEV;
+	if (READ_ONCE(vf->read_mode) == VGA_BALL_READ_EVENTS)
+		return read_events(vf, f, buf, count);
+	if (count < sizeof(frame))
+		return -EINVAL;
+
+	if (f->f_flags & O_NONBLOCK) {
+		if (READ_ONCE(dev->frame) == vf->last_frame)
+			return -EAGAIN;
+	} else {
+		ret = wait_event_interruptible(dev->frame_wait,
+				READ_ONCE(dev->frame) != vf->last_frame);
+		if (ret)
+			return ret;
+	}
+
+	spin_lock_irqsave(&dev->frame_lock, flags);
+	frame.frame = dev->frame;
+	frame.timestamp = ktime_to_ns(dev->frame_time);
+	spin_unlock_irqrestore(&dev->frame_lock, flags);
+
+	if (copy_to_user(buf, &frame, sizeof(frame)))
+		return -EFAULT;
+	vf->last_frame = frame.frame;
+	return sizeof(frame);
+}
+
+/*
+ * Room left in the hardware command FIFO
+ */
+static unsigned int cmd_space(struct vga_ball_dev *dev)
+{
+	u32 level = ioread32(CMD_LEVEL(dev->core.virtbase));
+
+	return level < VGA_BALL_CMD_DEPTH ? VGA_BALL_CMD_DEPTH - level : 0;
+}
+
+static bool valid_cmd(u32 cmd)
+{
+	switch (VGA_BALL_CMD_OP(cmd)) {
+	case VGA_BALL_CMD_SET_BG:
+	case VGA_BALL_CMD_SET_BALL:
+	case VGA_BALL_CMD_FLAP:
+	case VGA_BALL_CMD_COMMIT:
+		return true;
+	}
+	return false;
+}
+
+/*
+ * write() queues an array of VGA_BALL_CMD() words in the hardware
+ * command FIFO, which runs them at the start of the next frame.  Never
+ * pushes more than the FIFO has room for, so nothing is dropped; when
+ * it is full, waits for the next frame to drain it; with O_NONBLOCK,
+ * stops there instead.  Returns the bytes queued, or -EAGAIN if none.
+ */
+static ssize_t vga_ball_write(struct file *f, const char __user *buf,
+			      size_t count, loff_t *offp)
+{
+	struct vga_ball_file *vf = f->private_data;
+	struct vga_ball_dev *dev = vf->dev;
+	u32 chunk[VGA_BALL_CMD_DEPTH];
+	size_t total = count / sizeof(u32), done = 0;
+	unsigned int space, n, i;
+	ssize_t ret = 0;
+
+	if (count % sizeof(u32))
+		return -EINVAL;
+
+	if (mutex_lock_interruptible(&dev->cmd_lock))
+		return -ERESTARTSYS;
+
+	while (done < total) {
+		space = cmd_space(dev);
+		if (!space) {
+			if (f->f_flags & O_NONBLOCK) {
+				ret = -EAGAIN;
+				break;
+			}
+			/* Drained at the next vsync; poll without the IRQ */
+			ret = wait_event_interruptible_timeout(dev->frame_wait,
+					cmd_space(dev), msecs_to_jiffies(20));
+			if (ret < 0)
+				break;
+			ret = 0;
+			continue;
+		}
+
+		n = min_t(size_t, total - done, space);
+		if (copy_from_user(chunk, buf + done * sizeof(u32),
+				   n * sizeof(u32))) {
+			ret = -EFAULT;
+			break;
+		}
+		for (i = 0; i < n; i++) {
+			if (!valid_cmd(chunk[i])) {
+				ret = -EINVAL;
+				break;
+			}
+			iowrite32(chunk[i], CMD_FIFO(dev->core.virtbase));
+		}
+		done += i;
+		atomic_long_add(i, &dev->cmds_queued);
+		if (i)
+			vga_ball_cmds_queued(&dev->core);
+		if (ret)
+			break;
+	}
+
+	mutex_unlock(&dev->cmd_lock);
+	return done ? done * sizeof(u32) : ret;
+}
+
+static __poll_t vga_ball_poll(struct file *f, poll_table *wait)
+{
+	struct vga_ball_file *vf = f->private_data;
+	struct vga_ball_dev *dev = vf->dev;
+	__poll_t mask = 0;
+
+	if (!dev->irq)
+		return EPOLLERR;
+
+	poll_wait(f, &dev->frame_wait, wait);
+	if (READ_ONCE(vf->read_mode) == VGA_BALL_READ_EVENTS ?
+	    !kfifo_is_empty(&vf->events) :
+	    READ_ONCE(dev->frame) != vf->last_frame)
+		mask |= EPOLLIN | EPOLLRDNORM;
+	if (cmd_space(dev))
+		mask |= EPOLLOUT | EPOLLWRNORM;
+	return mask;
+}
+
+/*
+ * While the registers are mapped, userspace can change them behind
+ * write_shadow()'s back, so it stops eliding writes; once the last
+ * mapping goes, what it remembers is stale.
+ */
+static void vga_ball_vm_open(struct vm_area_struct *vma)
+{
+	struct vga_ball_dev *dev = vma->vm_private_data;
+
+	atomic_inc(&dev->core.mappings);
+}
+
+static void vga_ball_vm_close(struct vm_area_struct *vma)
+{
+	struct vga_ball_dev *dev = vma->vm_private_data;
+
+	if (atomic_dec_and_test(&dev->core.mappings))
+		vga_ball_forget_shadow(&dev->core);
+}
+
+static const struct vm_operations_struct vga_ball_vm_ops = {
+	.open	= vga_ball_vm_open,
+	.close	= vga_ball_vm_close,
+};
+
+/*
+ * Map background i, at VGA_BALL_MMAP_BACKGROUND(i), for userspace to
+ * draw in
+ */
+static int mmap_background(struct vga_ball_dev *dev,
+			   struct vm_area_struct *vma)
+{
+	unsigned long offset = vma->vm_pgoff << PAGE_SHIFT;
+	int i;
+
+	for (i = 0; i < dev->core.backgrounds; i++)
+		if (offset == VGA_BALL_MMAP_BACKGROUND(i)) {
+			/* The offset picked the buffer; map from its start */
+			vma->vm_pgoff = 0;
+			return dma_mmap_coherent(dev->misc.parent, vma,
+						 dev->background[i],
+						 dev->background_dma[i],
+						 VGA_BALL_BACKGROUND_SIZE);
+		}
+	return -EINVAL;
+}
+
+/*
+ * Map our register page uncached into userspace so registers can be
+ * written with plain stores (see vga_ball_regs.h), or a background
+ */
+static int vga_ball_mmap(struct file *f, struct vm_area_struct *vma)
+{
+	struct vga_ball_file *vf = f->private_data;
+	struct vga_ball_dev *dev = vf->dev;
+	int ret;
+
+	if (vma->vm_pgoff)
+		return mmap_background(dev, vma);
+
+	/* Userspace expects the registers at the start of the page */
+	if (offset_in_page(dev->res.start))
+		return -ENXIO;
+
+	vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
+	ret = vm_iomap_memory(vma, dev->res.start, resource_size(&dev->res));
+	if (ret)
+		return ret;
+
+	vma->vm_ops = &vga_ball_vm_ops;
+	vma->vm_private_data = dev;
+	vga_ball_vm_open(vma);
+	return 0;
+}
+
+/* The operations our device knows how to do */
+static const struct file_operations vga_ball_fops = {
+	.owner		= THIS_MODULE,
+	.open		= vga_ball_open,
+	.release	= vga_ball_release,
+	.read		= vga_ball_read,
+	.write		= vga_ball_write,
+	.poll		= vga_ball_poll,
+	.unlocked_ioctl = vga_ball_ioctl,
+	.mmap		= vga_ball_mmap,
+};
+
+/*
+ * Allocate the backgrounds the hardware can read by DMA.  They are
+ * optional: without them the tiles are all there is.
+ */
+static void alloc_backgrounds(struct platform_device *pdev,
+			      struct vga_ball_dev *dev)
+{
+	int i;
+
+	/* DMA_BASE is a 32-bit register */
+	if (dma_set_mask_and_coherent(&pdev->dev, DMA_BIT_MASK(32))) {
+		pr_warn("%s: no 32-bit DMA; backgrounds disabled\n", dev->name);
+		return;
+	}
+	for (i = 0; i < VGA_BALL_BACKGROUNDS; i++) {
+		dev->background[i] = dmam_alloc_coherent(&pdev->dev,
+						VGA_BALL_BACKGROUND_SIZE,
+						&dev->background_dma[i],
+						GFP_KERNEL);
+		if (!dev->background[i])
+			break;
+		dev->core.background_dma[i] = dev->background_dma[i];
+	}
+	dev->core.backgrounds = i;
+	if (i < VGA_BALL_BACKGROUNDS)
+		pr_warn("%s: only %d of %d backgrounds allocated\n",
+			dev->name, i, VGA_BALL_BACKGROUNDS);
+}
+
+#define DMA_STOP_US 100 /* Far more than the one burst in flight needs */
+
+/*
+ * Stop the background DMA before its buffers are freed.  Reads already
+ * requested still arrive; DMA_BUSY says when they are all in.
+ */
+static void stop_backgrounds(struct vga_ball_dev *dev)
+{
+	unsigned int us;
+
+	iowrite32(VGA_BALL_DMA_STOP, DMA_CTRL(dev->core.virtbase));
+	for (us = 0; ioread32(DMA_BUSY(dev->core.virtbase)); us++) {
+		if (us == DMA_STOP_US) {
+			pr_warn("%s: background DMA did not stop\n", dev->name);
+			break;
+		}
+		udelay(1);
+	}
+}
+
+/*
+ * Initialization code: get resources (registers) and display
+ * a welcome message.  Called once per matching device tree node; the
+ * first becomes /dev/vga_ball, the next /dev/vga_ball1, and so on.
+ */
+static int __init vga_ball_probe(struct platform_device *pdev)
+{
+	vga_ball_color_t sky = { 0x40, 0xc0, 0xc0 }; /* As bg.mif has it */
+	vga_ball_position_t initial_ball = { VGA_BALL_BALL_HIDDEN, 240, 0 };
+	struct vga_ball_dev *dev;
+	void __iomem *base;
+	int ret;
+
+	dev = devm_kzalloc(&pdev->dev, sizeof(*dev), GFP_KERNEL);
+	if (!dev)
+		return -ENOMEM;
+	spin_lock_init(&dev->frame_lock);
+	init_waitqueue_head(&dev->frame_wait);
+	mutex_init(&dev->cmd_lock);
+	INIT_LIST_HEAD(&dev->files);
+
+	dev->id = ida_alloc(&vga_ball_ida, GFP_KERNEL);
+	if (dev->id < 0)
+		return dev->id;
+	if (dev->id)
+		snprintf(dev->name, sizeof(dev->name), DRIVER_NAME "%d",
+			 dev->id);
+	else
+		strscpy(dev->name, DRIVER_NAME, sizeof(dev->name));
+
+	/* Get the address of our registers from the device tree */
+	ret = of_address_to_resource(pdev->dev.of_node, 0, &dev->res);
+	if (ret) {
+		ret = -ENOENT;
+		goto out_free_id;
+	}
+
+	/* Make sure we can use these registers */
+	if (request_mem_region(dev->res.start, resource_size(&dev->res),
+			       dev->name) == NULL) {
+		ret = -EBUSY;
+		goto out_free_id;
+	}
+
+	/* Arrange access to our registers */
+	base = of_iomap(pdev->dev.of_node, 0);
+	if (base == NULL) {
+		ret = -ENOMEM;
+		goto out_release_mem_region;
+	}
+	vga_ball_core_init(&dev->core, base);
+        
+	/* Start from the sky the tiles were drawn with, and no ball */
+	vga_ball_write_background(&dev->core, &sky);
+	vga_ball_write_ball_position(&dev->core, &initial_ball);
+	/* Nothing is on screen yet, so there is no need to wait for vsync */
+	vga_ball_commit(&dev->core, VGA_BALL_COMMIT_NOW);
+
+    	vga_ball_write_flap(&dev->core, 0);
+
+	alloc_backgrounds(pdev, dev);
+
+	/* Vsync interrupt: without one, read() and poll() are unavailable */
+	dev->irq = irq_of_parse_and_map(pdev->dev.of_node, 0);
+	if (dev->irq) {
+		ret = request_irq(dev->irq, vga_ball_irq, 0, dev->name, dev);
+		if (ret)
+			goto out_unmap;
+		iowrite32(1, IRQ_ENABLE(dev->core.virtbase));
+	} else
+		pr_warn("%s: no interrupt; frame reads disabled\n", dev->name);
+
+	/* Counters for /sys/kernel/debug/vga_ball*; failure is not fatal */
+	dev->debugfs = debugfs_create_dir(dev->name, NULL);
+	debugfs_create_file("counters", 0444, dev->debugfs, dev,
+			    &counters_fops);
+
+	/* Register ourselves as a misc device, now that it is ready for
+	   use: creates /dev/vga_ball (or vga_ballN) */
+	dev->misc.minor = MISC_DYNAMIC_MINOR;
+	dev->misc.name = dev->name;
+	dev->misc.fops = &vga_ball_fops;
+	dev->misc.groups = vga_ball_groups;
+	dev->misc.parent = &pdev->dev;
+	ret = misc_register(&dev->misc);
+	if (ret)
+		goto out_free_irq;
+
+	platform_set_drvdata(pdev, dev);
+	return 0;
+
+out_free_irq:
+	debugfs_remove_recursive(dev->debugfs);
+	if (dev->irq) {
+		iowrite32(0, IRQ_ENABLE(dev->core.virtbase));
+		free_irq(dev->irq, dev);
+	}
+out_unmap:
+	iounmap(dev->core.virtbase);
+out_release_mem_region:
+	release_mem_region(dev->res.start, resource_size(&dev->res));
+out_free_id:
+	ida_free(&vga_ball_ida, dev->id);
+	return ret;
+}
+
+/* Clean-up code: release resources */
+static int vga_ball_remove(struct platform_device *pdev)
+{
+	struct vga_ball_dev *dev = platform_get_drvdata(pdev);
+
+	misc_deregister(&dev->misc);
+	debugfs_remove_recursive(dev->debugfs);
+	if (dev->irq) {
+		iowrite32(0, IRQ_ENABLE(dev->core.virtbase));
+		free_irq(dev->irq, dev);
+	}
+	/* The backgrounds are freed after we return */
+	stop_backgrounds(dev);
+	iounmap(dev->core.virtbase);
+	release_mem_region(dev->res.start, resource_size(&dev->res));
+	ida_free(&vga_ball_ida, dev->id);
+	return 0;
+}
+
+/* Which "compatible" string(s) to search for in the Device Tree */
+#ifdef CONFIG_OF
+static const struct of_device_id vga_ball_of_match[] = {
+	{ .compatible = "csee4840,vga_ball-1.0" },
+	{},
+};
+MODULE_DEVICE_TABLE(of, vga_ball_of_match);
+#endif
+
+/* Information for registering ourselves as a "platform" driver */
+static struct platform_driver vga_ball_driver = {
+	.driver	= {
+		.name	= DRIVER_NAME,
+		.owner	= THIS_MODULE,
+		.of_match_table = of_match_ptr(vga_ball_of_match),
+	},
+	.remove	= __exit_p(vga_ball_remove),
+};
+
+/* Called when the module is loaded: set things up */
+static int __init vga_ball_init(void)
+{
+	pr_info(DRIVER_NAME ": init\n");
+	return platform_driver_probe(&vga_ball_driver, vga_ball_probe);
+}
+
+/* Calball when the module is unloaded: release resources */
+static void __exit vga_ball_exit(void)
+{
+	platform_driver_unregister(&vga_ball_driver);
+	pr_info(DRIVER_NAME ": exit\n");
+}
+
+module_init(vga_ball_init);
+module_exit(vga_ball_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR("Stephen A. Edwards, Columbia University");
+MODULE_DESCRIPTION("VGA ball driver");
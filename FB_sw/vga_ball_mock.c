@@ -0,0 +1,7 @@
+#include "vga_ball_mock.h"
+
+struct vga_ball_mock vga_ball_mock;
+
+void vga_ball_mock_reset(void) {
+  memset(&vga_ball_mock, 0, sizeof(vga_ball_mock));
+}
@@ -0,0 +1,93 @@
+#ifndef _VGA_BALL_MOCK_H
+#define _VGA_BALL_MOCK_H
+
+/*
+ * Just enough of the kernel for vga_ball_core.c to build as an ordinary
+ * program.  The registers are an array in memory that counts its
+ * accesses, user copies are memcpy() unless a test asks for one to
+ * fail, and tracepoints compile away.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define __iomem
+#define __user
+
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef pthread_spinlock_t spinlock_t;
+#define spin_lock_init(l) pthread_spin_init(l, PTHREAD_PROCESS_PRIVATE)
+#define spin_lock(l) pthread_spin_lock(l)
+#define spin_unlock(l) pthread_spin_unlock(l)
+
+typedef atomic_int atomic_t;
+typedef atomic_long atomic_long_t;
+#define atomic_read(v) atomic_load(v)
+#define atomic_inc(v) atomic_fetch_add(v, 1)
+#define atomic_dec_and_test(v) (atomic_fetch_sub(v, 1) == 1)
+#define atomic_cmpxchg(v, old, new) mock_atomic_cmpxchg(v, old, new)
+#define atomic_long_read(v) atomic_load(v)
+#define atomic_long_inc(v) atomic_fetch_add(v, 1)
+#define atomic_long_add(i, v) atomic_fetch_add(v, i)
+
+static inline int mock_atomic_cmpxchg(atomic_t *v, int old, int new)
+{
+  atomic_compare_exchange_strong(v, &old, new);
+  return old;
+}
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define min_t(type, a, b) ((type) (a) < (type) (b) ? (type) (a) : (type) (b))
+
+/* Userspace is the same address space here; see vga_ball_mock.fault */
+#define copy_from_user(to, from, n) \
+  (vga_ball_mock_fault() ? (n) : (memcpy(to, from, n), 0))
+#define copy_to_user(to, from, n) \
+  (vga_ball_mock_fault() ? (n) : (memcpy(to, from, n), 0))
+#define put_user(x, p) (vga_ball_mock_fault() ? -EFAULT : (*(p) = (x), 0))
+#define u64_to_user_ptr(x) ((void *) (uintptr_t) (x))
+
+#define trace_vga_ball_flap(value) do { } while (0)
+#define trace_vga_ball_background(background) do { } while (0)
+#define trace_vga_ball_ball(ball) do { } while (0)
+
+/* The 1 KiB register span of the Avalon slave */
+#define VGA_BALL_MOCK_WORDS 256
+
+struct vga_ball_mock {
+  u32 regs[VGA_BALL_MOCK_WORDS];
+  unsigned long reads, writes;      /* Bus accesses so far */
+  unsigned long copies;             /* User copies so far */
+  unsigned long fault;              /* Copy number that faults; 0: none */
+};
+
+extern struct vga_ball_mock vga_ball_mock;
+
+/* Forget all register contents, access counts and faults */
+extern void vga_ball_mock_reset(void);
+
+/* Count one user copy; true if it is the one that should fail */
+static inline bool vga_ball_mock_fault(void)
+{
+  return ++vga_ball_mock.copies == vga_ball_mock.fault;
+}
+
+static inline void iowrite32(u32 value, void *addr)
+{
+  vga_ball_mock.writes++;
+  *(volatile u32 *) addr = value;
+}
+
+static inline u32 ioread32(void *addr)
+{
+  vga_ball_mock.reads++;
+  return *(volatile u32 *) addr;
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef _VGA_BALL_REGS_H
+#define _VGA_BALL_REGS_H
+
+/*
+ * Register map of the vga_ball peripheral, shared by the driver and by
+ * programs that mmap() /dev/vga_ball.  Every register is a 32-bit word
+ * at the byte offset given; access them only with 32-bit loads and
+ * stores (iowrite32/ioread32).
+ *
+ * BG and BALL are double-buffered: writes land in a shadow set that
+ * COMMIT copies to the active set in one step, and the display draws
+ * from the active set.  BG colors the sky (the tile pixels bg.mif has
+ * as 0xD9; 0xc0c040 draws them unchanged); BALL places the center of a
+ * white ball, which is hidden while x is 640 or more.
+ */
+#define VGA_BALL_REG_BG          0x00  /* 0x00BBGGRR */
+#define VGA_BALL_REG_BALL        0x04  /* y in [25:16], x in [9:0] */
+#define VGA_BALL_REG_FLAP        0x08  /* Writing 1 queues one flap */
+#define VGA_BALL_NUM_DISPLAY_REGS 3    /* The registers above */
+#define VGA_BALL_BALL_HIDDEN     0x3ff /* A BALL x that hides the ball */
+
+/* Vsync interrupt; owned by the driver */
+#define VGA_BALL_REG_IRQ_ENABLE  0x0C  /* Bit 0 enables the interrupt */
+#define VGA_BALL_REG_IRQ_ACK     0x10  /* Any write acknowledges it */
+
+/* Shadow-to-active copy of BG and BALL */
+#define VGA_BALL_REG_COMMIT      0x14
+#define VGA_BALL_COMMIT_VSYNC    0x01  /* Copy at the next vsync edge */
+#define VGA_BALL_COMMIT_NOW      0x02  /* Copy at once */
+
+/* Command FIFO.  Each write to CMD_FIFO pushes one command; the
+   hardware runs the commands queued at the start of each frame, in
+   order, during vertical blanking. */
+#define VGA_BALL_REG_CMD_FIFO    0x18  /* Write only */
+#define VGA_BALL_CMD_DEPTH       64
+#define VGA_BALL_CMD(op, payload) \
+  ((unsigned int) (op) << 24 | ((unsigned int) (payload) & 0xffffff))
+#define VGA_BALL_CMD_OP(cmd)     ((cmd) >> 24)
+#define VGA_BALL_CMD_SET_BG      0x01  /* payload 0xBBGGRR, to the shadow */
+#define VGA_BALL_CMD_SET_BALL    0x02  /* payload VGA_BALL_CMD_XY(x, y) */
+#define VGA_BALL_CMD_FLAP        0x03  /* Queue one flap */
+#define VGA_BALL_CMD_COMMIT      0x04  /* Shadow to active, at once */
+#define VGA_BALL_CMD_XY(x, y) \
+  (((unsigned int) (x) & 0x3ff) | ((unsigned int) (y) & 0x3ff) << 10)
+
+/* Background tile map: 80x60 positions of 8x8 tiles, each holding a
+   tile number.  Set TILEMAP_ADDR, then each write to TILEMAP_DATA
+   stores one tile number and moves to the next position.  Takes effect
+   at once, not at COMMIT. */
+#define VGA_BALL_REG_TILEMAP_ADDR 0x1C
+#define VGA_BALL_REG_TILEMAP_DATA 0x20  /* Write only */
+#define VGA_BALL_TILEMAP_WIDTH    80
+#define VGA_BALL_TILEMAP_HEIGHT   60
+#define VGA_BALL_TILEMAP_POS(x, y) ((y) * VGA_BALL_TILEMAP_WIDTH + (x))
+
+/* Background DMA.  With DMA_CTRL bit 0 set, the background is read
+   from a 640x480-byte frame at physical address DMA_BASE instead of
+   the tiles; both take effect at the next vsync, turning it on or off.
+   Writing DMA_STOP turns it off at once instead, and DMA_BUSY reads 1
+   until the reads already requested are in.  The driver owns these:
+   see VGA_BALL_SHOW_BACKGROUND. */
+#define VGA_BALL_REG_DMA_BASE     0x24
+#define VGA_BALL_REG_DMA_CTRL     0x28
+#define VGA_BALL_DMA_ENABLE       0x01
+#define VGA_BALL_DMA_STOP         0x02
+
+/* Sprite sheet: 16 KB of pixels (RRRGGGBB, 0 transparent) that the
+   image table points into.  Set SHEET_ADDR, then each write to
+   SHEET_DATA stores one pixel and moves to the next.  Like the tile
+   map, changes show at once. */
+#define VGA_BALL_REG_SHEET_ADDR   0x2C
+#define VGA_BALL_REG_SHEET_DATA   0x30  /* Write only */
+#define VGA_BALL_SHEET_SIZE       16384
+
+/* Live game state, read only.  Reading STATUS snapshots all of them;
+   the others return the snapshot. */
+#define VGA_BALL_REG_STATUS      0x40
+#define VGA_BALL_REG_BIRD_Y      0x44  /* 10 bits */
+#define VGA_BALL_REG_PIPE(i)     (0x48 + 4 * (i))  /* gap_y [24:16], x [9:0] */
+#define VGA_BALL_REG_FLAP_COUNTS 0x54  /* dropped [31:16], received [15:0] */
+
+/* STATUS fields */
+#define VGA_BALL_STATUS_SCORE(v)        ((v) & 0xffff)
+#define VGA_BALL_STATUS_GAME_STATE(v)   (((v) >> 16) & 0x3)  /* vga_ball.h */
+#define VGA_BALL_STATUS_FLAP_PENDING(v) (((v) >> 20) & 0x7)
+
+/* Frame and cycle counters, read only.  Reading FRAME, or STATUS,
+   snapshots all three. */
+#define VGA_BALL_REG_FRAME        0x58  /* Vsync edges since reset */
+#define VGA_BALL_REG_VSYNC_CYCLES 0x5C  /* Low word of CYCLES at the last one */
+#define VGA_BALL_REG_CYCLES       0x60  /* 64 bits: low word, then high */
+
+/* Active BG and BALL, read only (nothing is drawn from them).  Reading
+   ACTIVE_BG snapshots them and COMMIT_PENDING together. */
+#define VGA_BALL_REG_ACTIVE_BG      0x70
+#define VGA_BALL_REG_ACTIVE_BALL    0x74
+#define VGA_BALL_REG_COMMIT_PENDING 0x78  /* 1 until an armed copy is done */
+
+/* Command FIFO status, read only and live */
+#define VGA_BALL_REG_CMD_LEVEL      0x7C  /* Commands queued, 0-64 */
+#define VGA_BALL_REG_CMD_OVERFLOWS  0x80  /* Pushes dropped: FIFO full */
+
+/* Game events, read only.  Reading EVENTS clears the flags.  The score
+   and game state are live. */
+#define VGA_BALL_REG_EVENTS         0x84
+#define VGA_BALL_EVENTS_FLAGS(v)      ((v) & 0x7)  /* 1 << VGA_BALL_EVENT_* */
+#define VGA_BALL_EVENTS_GAME_STATE(v) (((v) >> 8) & 0x3)
+#define VGA_BALL_EVENTS_SCORE(v)      (((v) >> 16) & 0xffff)
+
+/* Background DMA status, read only and live */
+#define VGA_BALL_REG_DMA_UNDERRUNS  0x88  /* Rows not fetched in time */
+#define VGA_BALL_REG_DMA_BUSY       0x90  /* 1 while reads are in flight */
+
+/* Sprite status, read only and live */
+#define VGA_BALL_REG_SPRITE_DROPS   0x8C  /* Rows with sprites not drawn */
+
+/* Sprite and image tables, read/write (see vga_ball.h).  Writes to
+   sprites 0 and 1 are ignored; reading them returns what the game
+   draws.  Changes show from the next row drawn. */
+#define VGA_BALL_REG_SPRITE_POS(i)  (0x100 + 8 * (i))  /* SPRITE_XY() */
+#define VGA_BALL_REG_SPRITE_CTRL(i) (0x104 + 8 * (i))  /* SPRITE_CTRL() */
+#define VGA_BALL_REG_IMAGE(i)       (0x180 + 4 * (i))  /* IMAGE() */
+#define VGA_BALL_SPRITE_ENABLE      0x80000000
+
+/* Packing helpers */
+#define VGA_BALL_BG(r, g, b) \
+  ((unsigned int) (r) | (unsigned int) (g) << 8 | (unsigned int) (b) << 16)
+#define VGA_BALL_XY(x, y) \
+  (((unsigned int) (x) & 0x3ff) | ((unsigned int) (y) & 0x3ff) << 16)
+#define VGA_BALL_SPRITE_XY(x, y) \
+  (((unsigned int) (x) & 0x7ff) | ((unsigned int) (y) & 0x7ff) << 16)
+#define VGA_BALL_SPRITE_CTRL(priority, frame) \
+  (VGA_BALL_SPRITE_ENABLE | ((unsigned int) (priority) & 0x3) << 24 | \
+   ((unsigned int) (frame) & 0xff))
+#define VGA_BALL_IMAGE(width, height, base) \
+  (((unsigned int) (height) & 0xff) << 24 | \
+   ((unsigned int) (width) & 0xff) << 16 | ((unsigned int) (base) & 0x3fff))
+#define VGA_BALL_LO(v)  ((v) & 0xffff)
+#define VGA_BALL_HI(v)  (((v) >> 16) & 0xffff)
+
+#define VGA_BALL_CLOCK_HZ     50000000
+#define VGA_BALL_FRAME_CYCLES (1600 * 525)  /* One 640x480 frame at 50 MHz */
+
+#ifndef __KERNEL__
+
+/*
+ * Userspace accessor: map the register page once, then every register
+ * update is a single uncached store with no system call.
+ *
+ *   struct vga_ball_regs regs;
+ *   if (vga_ball_regs_map(&regs, fd) == 0)
+ *       vga_ball_regs_flap(&regs);
+ */
+
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct vga_ball_regs {
+  volatile uint32_t *base;
+  size_t len;
+};
+
+/* Map the registers of an open /dev/vga_ball.  Returns 0 or -1 (errno) */
+static inline int vga_ball_regs_map(struct vga_ball_regs *regs, int fd)
+{
+  void *p;
+
+  regs->len = sysconf(_SC_PAGESIZE);
+  p = mmap(NULL, regs->len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED)
+    return -1;
+  regs->base = p;
+  return 0;
+}
+
+static inline void vga_ball_regs_unmap(struct vga_ball_regs *regs)
+{
+  munmap((void *) regs->base, regs->len);
+}
+
+/* reg is a VGA_BALL_REG_* byte offset */
+static inline void vga_ball_regs_write(struct vga_ball_regs *regs,
+                                       unsigned int reg, uint32_t value)
+{
+  regs->base[reg / 4] = value;
+}
+
+static inline uint32_t vga_ball_regs_read(struct vga_ball_regs *regs,
+                                          unsigned int reg)
+{
+  return regs->base[reg / 4];
+}
+
+/* 64-bit read, low word first */
+static inline uint64_t vga_ball_regs_read64(struct vga_ball_regs *regs,
+                                            unsigned int reg)
+{
+  uint64_t lo = regs->base[reg / 4];
+
+  return lo | (uint64_t) regs->base[reg / 4 + 1] << 32;
+}
+
+/* Copy the shadow registers to the active set at the next vsync */
+static inline void vga_ball_regs_commit(struct vga_ball_regs *regs)
+{
+  regs->base[VGA_BALL_REG_COMMIT / 4] = VGA_BALL_COMMIT_VSYNC;
+}
+
+/* Push one VGA_BALL_CMD(); check CMD_LEVEL first, a full FIFO drops it */
+static inline void vga_ball_regs_push(struct vga_ball_regs *regs,
+                                      uint32_t cmd)
+{
+  regs->base[VGA_BALL_REG_CMD_FIFO / 4] = cmd;
+}
+
+/* Queue one flap; the hardware applies it at the next physics tick */
+static inline void vga_ball_regs_flap(struct vga_ball_regs *regs)
+{
+  regs->base[VGA_BALL_REG_FLAP / 4] = 1;
+}
+
+#endif /* __KERNEL__ */
+
+#endif
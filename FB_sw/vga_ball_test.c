@@ -0,0 +1,357 @@
+/*
+ * Check the vga_ball driver's ioctl paths on the host
+ *
+ * Runs vga_ball_core.c against the mock registers of vga_ball_mock.c
+ * and checks, for each ioctl, what it returns and which registers it
+ * writes.  "make test" builds and runs it; it exits nonzero if any
+ * check fails.
+ */
+
+#include "vga_ball_core.h"
+#include "vga_ball_regs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static struct vga_ball_core core;
+static unsigned int checks, failures;
+
+#define CHECK(cond)                                                     \
+  do {                                                                  \
+    checks++;                                                           \
+    if (!(cond)) {                                                      \
+      failures++;                                                       \
+      fprintf(stderr, "%s:%d: %s: failed: %s\n", __FILE__, __LINE__,    \
+              __func__, #cond);                                         \
+    }                                                                   \
+  } while (0)
+
+/* The mock register at byte offset reg */
+#define REG(reg) vga_ball_mock.regs[(reg) / 4]
+
+/* A device the driver has just probed: nothing known, no backgrounds */
+static void fresh_core(void) {
+  vga_ball_mock_reset();
+  memset(&core, 0, sizeof(core));
+  vga_ball_core_init(&core, vga_ball_mock.regs);
+}
+
+static long ioctl_ptr(unsigned int cmd, void *arg) {
+  return vga_ball_core_ioctl(&core, cmd, (unsigned long) arg);
+}
+
+static void test_background_and_ball(void) {
+  vga_ball_arg_t vla = { .background = { 0x11, 0x22, 0x33 },
+                         .ball = { 320, 240, 0 } };
+  vga_ball_arg_t out;
+
+  fresh_core();
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+  CHECK(REG(VGA_BALL_REG_BG) == VGA_BALL_BG(0x11, 0x22, 0x33));
+  CHECK(REG(VGA_BALL_REG_COMMIT) == VGA_BALL_COMMIT_VSYNC);
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BALL, &vla) == 0);
+  CHECK(REG(VGA_BALL_REG_BALL) == VGA_BALL_XY(320, 240));
+
+  memset(&out, 0, sizeof(out));
+  CHECK(ioctl_ptr(VGA_BALL_READ_BACKGROUND, &out) == 0);
+  CHECK(out.background.red == 0x11 && out.background.green == 0x22 &&
+        out.background.blue == 0x33);
+  CHECK(ioctl_ptr(VGA_BALL_READ_BALL, &out) == 0);
+  CHECK(out.ball.x == 320 && out.ball.y == 240);
+
+  /* The same values again: no bus writes at all, not even COMMIT */
+  vga_ball_mock.writes = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BALL, &vla) == 0);
+  CHECK(vga_ball_mock.writes == 0);
+  CHECK(atomic_long_read(&core.elided_writes) == 4);
+}
+
+static void test_queued_commands(void) {
+  vga_ball_arg_t vla = { .background = { 1, 2, 3 } };
+
+  fresh_core();
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+
+  /* Queued commands may still change BG: the same write goes out */
+  REG(VGA_BALL_REG_CMD_LEVEL) = 1;
+  vga_ball_cmds_queued(&core);
+  vga_ball_mock.writes = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+  CHECK(vga_ball_mock.writes == 2);
+
+  /* Not drained yet at this vsync */
+  vga_ball_check_cmds(&core);
+  CHECK(atomic_read(&core.cmds_pending) != 0);
+
+  /* Drained: the next write is trusted again, the one after elided */
+  REG(VGA_BALL_REG_CMD_LEVEL) = 0;
+  vga_ball_check_cmds(&core);
+  CHECK(atomic_read(&core.cmds_pending) == 0);
+  vga_ball_mock.writes = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+  CHECK(vga_ball_mock.writes == 2);
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == 0);
+  CHECK(vga_ball_mock.writes == 2);
+}
+
+static void test_flap(void) {
+  vga_ball_arg_t vla = { .flap = 7 };
+
+  fresh_core();
+  CHECK(ioctl_ptr(VGA_BALL_FLAP, NULL) == 0);
+  CHECK(REG(VGA_BALL_REG_FLAP) == 1);
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_FLAP, &vla) == 0);
+  CHECK(REG(VGA_BALL_REG_FLAP) == 1);
+  vla.flap = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_FLAP, &vla) == 0);
+  CHECK(REG(VGA_BALL_REG_FLAP) == 0);
+}
+
+static void test_batch(void) {
+  vga_ball_write_t writes[] = {
+    { VGA_BALL_REG_BG, VGA_BALL_BG(4, 5, 6) },
+    { VGA_BALL_REG_SPRITE_POS(VGA_BALL_HW_SPRITES), 0x12345 },
+    { VGA_BALL_REG_STATUS, 1 },       /* Read only: the batch stops here */
+    { VGA_BALL_REG_BALL, VGA_BALL_XY(1, 2) },
+  };
+  vga_ball_batch_t batch = { (uintptr_t) writes, 4, 99 };
+  vga_ball_write_t owned = { VGA_BALL_REG_SPRITE_CTRL(0), 0 };
+  vga_ball_write_t many[40];
+  unsigned int i;
+
+  fresh_core();
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == 2);
+  CHECK(batch.applied == 2);
+  CHECK(REG(VGA_BALL_REG_BG) == VGA_BALL_BG(4, 5, 6));
+  CHECK(REG(VGA_BALL_REG_SPRITE_POS(VGA_BALL_HW_SPRITES)) == 0x12345);
+  CHECK(REG(VGA_BALL_REG_STATUS) == 0);
+  CHECK(REG(VGA_BALL_REG_BALL) == 0);
+
+  /* Nothing applied: the error itself */
+  batch.writes = (uintptr_t) &writes[2];
+  batch.count = 2;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EINVAL);
+  CHECK(batch.applied == 0);
+
+  /* The game's own sprites are not userspace's to move */
+  batch.writes = (uintptr_t) &owned;
+  batch.count = 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EINVAL);
+
+  /* Unaligned */
+  owned.reg = VGA_BALL_REG_BG + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EINVAL);
+
+  /* An empty batch applies nothing and succeeds */
+  batch.count = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == 0);
+
+  /* More than one chunk, all applied in order */
+  for (i = 0; i < 40; i++) {
+    many[i].reg = VGA_BALL_REG_TILEMAP_DATA;
+    many[i].value = i;
+  }
+  batch.writes = (uintptr_t) many;
+  batch.count = 40;
+  vga_ball_mock.writes = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == 40);
+  CHECK(batch.applied == 40);
+  CHECK(vga_ball_mock.writes == 40);
+  CHECK(REG(VGA_BALL_REG_TILEMAP_DATA) == 39);
+}
+
+static void test_commit(void) {
+  fresh_core();
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_COMMIT, 0) == 0);
+  CHECK(REG(VGA_BALL_REG_COMMIT) == VGA_BALL_COMMIT_VSYNC);
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_COMMIT,
+                            VGA_BALL_COMMIT_NOW) == 0);
+  CHECK(REG(VGA_BALL_REG_COMMIT) == VGA_BALL_COMMIT_NOW);
+
+  vga_ball_mock.writes = 0;
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_COMMIT, 4) == -EINVAL);
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_COMMIT,
+                            VGA_BALL_COMMIT_NOW | 0x80) == -EINVAL);
+  CHECK(vga_ball_mock.writes == 0);
+}
+
+static void test_read_state(void) {
+  vga_ball_state_t state;
+
+  fresh_core();
+  REG(VGA_BALL_REG_STATUS) = 5 << 20 | VGA_BALL_STATE_GAME_OVER << 16 | 1234;
+  REG(VGA_BALL_REG_BIRD_Y) = 321;
+  REG(VGA_BALL_REG_FLAP_COUNTS) = 3 << 16 | 65535;
+  REG(VGA_BALL_REG_PIPE(0)) = 150 << 16 | 640;
+  REG(VGA_BALL_REG_PIPE(2)) = 270 << 16 | 2;
+
+  memset(&state, 0xff, sizeof(state));
+  CHECK(ioctl_ptr(VGA_BALL_READ_STATE, &state) == 0);
+  CHECK(state.score == 1234);
+  CHECK(state.game_state == VGA_BALL_STATE_GAME_OVER);
+  CHECK(state.flap_pending == 5);
+  CHECK(state.bird_y == 321);
+  CHECK(state.flaps_received == 65535 && state.flaps_dropped == 3);
+  CHECK(state.pipes[0].x == 640 && state.pipes[0].gap_y == 150);
+  CHECK(state.pipes[1].x == 0 && state.pipes[1].gap_y == 0);
+  CHECK(state.pipes[2].x == 2 && state.pipes[2].gap_y == 270);
+}
+
+static void test_read_time(void) {
+  vga_ball_time_t time;
+
+  fresh_core();
+  REG(VGA_BALL_REG_FRAME) = 4000000000u;
+  REG(VGA_BALL_REG_VSYNC_CYCLES) = 0xdeadbeef;
+  REG(VGA_BALL_REG_CYCLES) = 0x89abcdef;
+  REG(VGA_BALL_REG_CYCLES + 4) = 0x01234567;
+
+  CHECK(ioctl_ptr(VGA_BALL_READ_TIME, &time) == 0);
+  CHECK(time.frame == 4000000000u);
+  CHECK(time.vsync_cycles == 0xdeadbeef);
+  CHECK(time.cycles == 0x0123456789abcdefull);
+}
+
+static void test_show_background(void) {
+  fresh_core();
+
+  /* No buffers could be allocated: only the tiles can be shown */
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_SHOW_BACKGROUND, 0) == -EINVAL);
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_SHOW_BACKGROUND,
+                            VGA_BALL_BACKGROUNDS) == -EINVAL);
+  CHECK(vga_ball_mock.writes == 0);
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_SHOW_BACKGROUND,
+                            VGA_BALL_BACKGROUND_TILES) == 0);
+  CHECK(REG(VGA_BALL_REG_DMA_CTRL) == 0);
+
+  core.background_dma[0] = 0x30000000;
+  core.background_dma[1] = 0x30100000;
+  core.backgrounds = 2;
+  CHECK(vga_ball_core_ioctl(&core, VGA_BALL_SHOW_BACKGROUND, 1) == 0);
+  CHECK(REG(VGA_BALL_REG_DMA_BASE) == 0x30100000);
+  CHECK(REG(VGA_BALL_REG_DMA_CTRL) == VGA_BALL_DMA_ENABLE);
+}
+
+static void test_write_sprite(void) {
+  vga_ball_sprite_t sprite = { VGA_BALL_HW_SPRITES, -5, 479, 3,
+                               VGA_BALL_SPRITE_FRONT, 1, 0 };
+  unsigned int pos = VGA_BALL_REG_SPRITE_POS(VGA_BALL_HW_SPRITES);
+  unsigned int ctrl = VGA_BALL_REG_SPRITE_CTRL(VGA_BALL_HW_SPRITES);
+  vga_ball_sprite_t bad;
+
+  fresh_core();
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &sprite) == 0);
+  CHECK(REG(pos) == VGA_BALL_SPRITE_XY(-5, 479));
+  CHECK(REG(ctrl) == VGA_BALL_SPRITE_CTRL(VGA_BALL_SPRITE_FRONT, 3));
+  sprite.enable = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &sprite) == 0);
+  CHECK(!(REG(ctrl) & VGA_BALL_SPRITE_ENABLE));
+
+  sprite.index = VGA_BALL_SPRITES - 1;
+  sprite.x = -1024;
+  sprite.y = 1023;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &sprite) == 0);
+
+  vga_ball_mock.writes = 0;
+  bad = sprite, bad.index = 0;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.index = VGA_BALL_HW_SPRITES - 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.index = VGA_BALL_SPRITES;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.frame = VGA_BALL_IMAGES;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.priority = 4;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.x = 1024;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  bad = sprite, bad.y = -1025;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &bad) == -EINVAL);
+  CHECK(vga_ball_mock.writes == 0);
+}
+
+static void test_bad_commands(void) {
+  fresh_core();
+  CHECK(vga_ball_core_ioctl(&core, _IO(VGA_BALL_MAGIC, 99), 0) == -EINVAL);
+  CHECK(vga_ball_core_ioctl(&core, _IO('x', 6), 0) == -EINVAL);
+  /* Right number, wrong direction and size */
+  CHECK(vga_ball_core_ioctl(&core, _IO(VGA_BALL_MAGIC, 8), 0) == -EINVAL);
+  CHECK(atomic_long_read(&core.bad_cmd_count) == 3);
+  CHECK(vga_ball_mock.writes == 0 && vga_ball_mock.reads == 0);
+
+  CHECK(ioctl_ptr(VGA_BALL_FLAP, NULL) == 0);
+  CHECK(atomic_long_read(&core.cmd_count[_IOC_NR(VGA_BALL_FLAP)]) == 1);
+  CHECK(atomic_long_read(&core.bad_cmd_count) == 3);
+}
+
+/* Every user copy can fault; the ioctl says so and writes nothing */
+static void test_faults(void) {
+  vga_ball_arg_t vla = { .background = { 9, 9, 9 } };
+  vga_ball_sprite_t sprite = { VGA_BALL_HW_SPRITES, 0, 0, 0, 0, 1, 0 };
+  vga_ball_write_t writes[40];
+  vga_ball_batch_t batch = { (uintptr_t) writes, 40, 99 };
+  vga_ball_state_t state;
+  vga_ball_time_t time;
+  unsigned int i;
+
+  fresh_core();
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BACKGROUND, &vla) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BALL, &vla) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_FLAP, &vla) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_SPRITE, &sprite) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EACCES);
+  CHECK(vga_ball_mock.writes == 0);
+
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_READ_BACKGROUND, &vla) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_READ_BALL, &vla) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_READ_STATE, &state) == -EACCES);
+  vga_ball_mock.fault = vga_ball_mock.copies + 1;
+  CHECK(ioctl_ptr(VGA_BALL_READ_TIME, &time) == -EACCES);
+
+  /* A fault in the second chunk of a batch: the first is applied */
+  for (i = 0; i < 40; i++) {
+    writes[i].reg = VGA_BALL_REG_TILEMAP_DATA;
+    writes[i].value = i;
+  }
+  vga_ball_mock.writes = 0;
+  vga_ball_mock.fault = vga_ball_mock.copies + 3;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == 32);
+  CHECK(batch.applied == 32);
+  CHECK(vga_ball_mock.writes == 32);
+
+  /* ... and in the first chunk: none are */
+  batch.applied = 99;
+  vga_ball_mock.fault = vga_ball_mock.copies + 2;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EACCES);
+  CHECK(batch.applied == 0);
+
+  /* Storing applied faults */
+  vga_ball_mock.fault = vga_ball_mock.copies + 4;
+  CHECK(ioctl_ptr(VGA_BALL_WRITE_BATCH, &batch) == -EACCES);
+}
+
+int main(void) {
+  test_background_and_ball();
+  test_queued_commands();
+  test_flap();
+  test_batch();
+  test_commit();
+  test_read_state();
+  test_read_time();
+  test_show_background();
+  test_write_sprite();
+  test_bad_commands();
+  test_faults();
+
+  printf("%u checks, %u failed\n", checks, failures);
+  return failures != 0;
+}
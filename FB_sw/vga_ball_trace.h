@@ -0,0 +1,74 @@
+/*
+ * Tracepoints for the VGA ball driver
+ *
+ * Enable with
+ * echo 1 > /sys/kernel/debug/tracing/events/vga_ball/enable
+ * and read /sys/kernel/debug/tracing/trace_pipe
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM vga_ball
+
+#if !defined(_VGA_BALL_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _VGA_BALL_TRACE_H
+
+#include <linux/tracepoint.h>
+#include <linux/ktime.h>
+
+TRACE_EVENT(vga_ball_flap,
+	TP_PROTO(unsigned char value),
+	TP_ARGS(value),
+	TP_STRUCT__entry(
+		__field(unsigned char, value)
+		__field(s64, ktime)
+	),
+	TP_fast_assign(
+		__entry->value = value;
+		__entry->ktime = ktime_to_ns(ktime_get());
+	),
+	TP_printk("value=%u ktime=%lld", __entry->value, __entry->ktime)
+);
+
+TRACE_EVENT(vga_ball_background,
+	TP_PROTO(const vga_ball_color_t *background),
+	TP_ARGS(background),
+	TP_STRUCT__entry(
+		__field(unsigned char, red)
+		__field(unsigned char, green)
+		__field(unsigned char, blue)
+		__field(s64, ktime)
+	),
+	TP_fast_assign(
+		__entry->red = background->red;
+		__entry->green = background->green;
+		__entry->blue = background->blue;
+		__entry->ktime = ktime_to_ns(ktime_get());
+	),
+	TP_printk("red=0x%02x green=0x%02x blue=0x%02x ktime=%lld",
+		  __entry->red, __entry->green, __entry->blue, __entry->ktime)
+);
+
+TRACE_EVENT(vga_ball_ball,
+	TP_PROTO(const vga_ball_position_t *ball),
+	TP_ARGS(ball),
+	TP_STRUCT__entry(
+		__field(unsigned short, x)
+		__field(unsigned short, y)
+		__field(s64, ktime)
+	),
+	TP_fast_assign(
+		__entry->x = ball->x;
+		__entry->y = ball->y;
+		__entry->ktime = ktime_to_ns(ktime_get());
+	),
+	TP_printk("x=%u y=%u ktime=%lld", __entry->x, __entry->y, __entry->ktime)
+);
+
+#endif /* _VGA_BALL_TRACE_H */
+
+/* This part must be outside the include guard */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE vga_ball_trace
+#include <trace/define_trace.h>
@@ -4,7 +4,7 @@
 // MODULE: altsyncram 
 
 // ============================================================
-// File Name: bg_rom.v
+// File Name: tileset_rom.v
 // Megafunction Name(s):
 // 			altsyncram
 //
@@ -32,12 +32,12 @@
 //refer to the applicable agreement for further details, at
 //https://fpgasoftware.intel.com/eula.
 
-module bg_rom (
+module tileset_rom (
 	address,
 	clock,
 	q);
 
-	input	[18:0]  address;
+	input	[13:0]  address;
 	input	  clock;
 	output	[7:0]  q;
 `ifndef ALTERA_RESERVED_QIS
@@ -70,42 +70,42 @@ endmodule
 // Retrieval info: PRIVATE: JTAG_ENABLED NUMERIC "0"
 // Retrieval info: PRIVATE: JTAG_ID STRING "NONE"
 // Retrieval info: PRIVATE: MAXIMUM_DEPTH NUMERIC "0"
-// Retrieval info: PRIVATE: MIFfilename STRING "bg.mif"
-// Retrieval info: PRIVATE: NUMWORDS_A NUMERIC "307200"
+// Retrieval info: PRIVATE: MIFfilename STRING "tileset.mif"
+// Retrieval info: PRIVATE: NUMWORDS_A NUMERIC "16384"
 // Retrieval info: PRIVATE: RAM_BLOCK_TYPE NUMERIC "0"
 // Retrieval info: PRIVATE: RegAddr NUMERIC "1"
-// Retrieval info: PRIVATE: RegOutput NUMERIC "1"
+// Retrieval info: PRIVATE: RegOutput NUMERIC "0"
 // Retrieval info: PRIVATE: SYNTH_WRAPPER_GEN_POSTFIX STRING "0"
 // Retrieval info: PRIVATE: SingleClock NUMERIC "1"
 // Retrieval info: PRIVATE: UseDQRAM NUMERIC "0"
-// Retrieval info: PRIVATE: WidthAddr NUMERIC "19"
+// Retrieval info: PRIVATE: WidthAddr NUMERIC "14"
 // Retrieval info: PRIVATE: WidthData NUMERIC "8"
 // Retrieval info: PRIVATE: rden NUMERIC "0"
 // Retrieval info: LIBRARY: altera_mf altera_mf.altera_mf_components.all
 // Retrieval info: CONSTANT: ADDRESS_ACLR_A STRING "NONE"
 // Retrieval info: CONSTANT: CLOCK_ENABLE_INPUT_A STRING "BYPASS"
 // Retrieval info: CONSTANT: CLOCK_ENABLE_OUTPUT_A STRING "BYPASS"
-// Retrieval info: CONSTANT: INIT_FILE STRING "bg.mif"
+// Retrieval info: CONSTANT: INIT_FILE STRING "tileset.mif"
 // Retrieval info: CONSTANT: INTENDED_DEVICE_FAMILY STRING "Cyclone V"
 // Retrieval info: CONSTANT: LPM_HINT STRING "ENABLE_RUNTIME_MOD=NO"
 // Retrieval info: CONSTANT: LPM_TYPE STRING "altsyncram"
-// Retrieval info: CONSTANT: NUMWORDS_A NUMERIC "307200"
+// Retrieval info: CONSTANT: NUMWORDS_A NUMERIC "16384"
 // Retrieval info: CONSTANT: OPERATION_MODE STRING "ROM"
 // Retrieval info: CONSTANT: OUTDATA_ACLR_A STRING "NONE"
-// Retrieval info: CONSTANT: OUTDATA_REG_A STRING "CLOCK0"
-// Retrieval info: CONSTANT: WIDTHAD_A NUMERIC "19"
+// Retrieval info: CONSTANT: OUTDATA_REG_A STRING "UNREGISTERED"
+// Retrieval info: CONSTANT: WIDTHAD_A NUMERIC "14"
 // Retrieval info: CONSTANT: WIDTH_A NUMERIC "8"
 // Retrieval info: CONSTANT: WIDTH_BYTEENA_A NUMERIC "1"
-// Retrieval info: USED_PORT: address 0 0 19 0 INPUT NODEFVAL "address[18..0]"
+// Retrieval info: USED_PORT: address 0 0 14 0 INPUT NODEFVAL "address[13..0]"
 // Retrieval info: USED_PORT: clock 0 0 0 0 INPUT VCC "clock"
 // Retrieval info: USED_PORT: q 0 0 8 0 OUTPUT NODEFVAL "q[7..0]"
-// Retrieval info: CONNECT: @address_a 0 0 19 0 address 0 0 19 0
+// Retrieval info: CONNECT: @address_a 0 0 14 0 address 0 0 14 0
 // Retrieval info: CONNECT: @clock0 0 0 0 0 clock 0 0 0 0
 // Retrieval info: CONNECT: q 0 0 8 0 @q_a 0 0 8 0
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom.v TRUE
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom.inc FALSE
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom.cmp FALSE
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom.bsf FALSE
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom_inst.v FALSE
-// Retrieval info: GEN_FILE: TYPE_NORMAL bg_rom_bb.v TRUE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom.v TRUE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom.inc FALSE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom.cmp FALSE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom.bsf FALSE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom_inst.v FALSE
+// Retrieval info: GEN_FILE: TYPE_NORMAL tileset_rom_bb.v TRUE
 // Retrieval info: LIB_FILE: altera_mf
@@ -0,0 +1,125 @@
+/*
+ * Split the 640x480 background bitmap into 8x8 tiles
+ *
+ * Reads bg.mif (one 8-bit RRRGGGBB pixel per word, row by row), keeps
+ * one copy of each distinct tile, and writes
+ *
+ *   tileset.mif  TILES tiles of 64 pixels, row by row within a tile,
+ *                for tileset_rom (address {tile, row[2:0], col[2:0]})
+ *   tilemap.mif  the tile number of each of the 80x60 tile positions,
+ *                row by row, for the tile map RAM in vga_ball.sv
+ *
+ * Usage: bg2tiles bg.mif tileset.mif tilemap.mif
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WIDTH 640
+#define HEIGHT 480
+#define TILE 8                          /* Pixels on a side */
+#define TILES 256                       /* The tile map holds 8 bits */
+#define MAP_WIDTH (WIDTH / TILE)
+#define MAP_HEIGHT (HEIGHT / TILE)
+
+static unsigned char image[WIDTH * HEIGHT];
+static unsigned char tileset[TILES][TILE * TILE];
+static unsigned char tilemap[MAP_WIDTH * MAP_HEIGHT];
+static unsigned int ntiles;
+
+static void die(const char *msg, const char *name) {
+  fprintf(stderr, "bg2tiles: %s: %s\n", name, msg);
+  exit(1);
+}
+
+/*
+ * Read the CONTENT of a MIF: "addr : value;" and "[from..to] : value;"
+ * lines, addresses and values as ADDRESS_RADIX=UNS, DATA_RADIX=HEX
+ */
+static void read_mif(const char *name) {
+  FILE *f = fopen(name, "r");
+  char line[256];
+  unsigned long from, to, a;
+  unsigned int value;
+  int content = 0;
+
+  if (!f)
+    die("cannot open", name);
+  while (fgets(line, sizeof(line), f)) {
+    if (!content) {
+      content = strstr(line, "CONTENT BEGIN") != NULL;
+      continue;
+    }
+    if (sscanf(line, " [%lu..%lu] : %x;", &from, &to, &value) == 3)
+      ;
+    else if (sscanf(line, " %lu : %x;", &from, &value) == 2)
+      to = from;
+    else
+      continue;
+    if (to >= WIDTH * HEIGHT)
+      die("address past 640x480", name);
+    for (a = from; a <= to; a++)
+      image[a] = value;
+  }
+  fclose(f);
+  if (!content)
+    die("no CONTENT BEGIN", name);
+}
+
+/* The number of the tile with these pixels, adding it if it is new */
+static unsigned int find_tile(const unsigned char *pixels, const char *name) {
+  unsigned int t;
+
+  for (t = 0; t < ntiles; t++)
+    if (memcmp(tileset[t], pixels, TILE * TILE) == 0)
+      return t;
+  if (ntiles == TILES)
+    die("more than 256 distinct 8x8 tiles", name);
+  memcpy(tileset[ntiles], pixels, TILE * TILE);
+  return ntiles++;
+}
+
+static void write_mif(const char *name, const unsigned char *data,
+                      unsigned long depth) {
+  FILE *f = fopen(name, "w");
+  unsigned long a;
+
+  if (!f)
+    die("cannot create", name);
+  fprintf(f, "WIDTH=8;\nDEPTH=%lu;\nADDRESS_RADIX=UNS;\nDATA_RADIX=HEX;\n"
+          "CONTENT BEGIN\n", depth);
+  for (a = 0; a < depth; a++)
+    fprintf(f, "%lu : %02X;\n", a, data[a]);
+  fprintf(f, "END;\n");
+  if (fclose(f))
+    die("write failed", name);
+}
+
+int main(int argc, char **argv) {
+  unsigned char pixels[TILE * TILE];
+  unsigned int tx, ty, y;
+
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s bg.mif tileset.mif tilemap.mif\n", argv[0]);
+    exit(1);
+  }
+
+  read_mif(argv[1]);
+
+  for (ty = 0; ty < MAP_HEIGHT; ty++)
+    for (tx = 0; tx < MAP_WIDTH; tx++) {
+      for (y = 0; y < TILE; y++)
+        memcpy(pixels + y * TILE,
+               image + (ty * TILE + y) * WIDTH + tx * TILE, TILE);
+      tilemap[ty * MAP_WIDTH + tx] = find_tile(pixels, argv[1]);
+    }
+
+  write_mif(argv[2], &tileset[0][0], sizeof(tileset));
+  write_mif(argv[3], tilemap, sizeof(tilemap));
+
+  printf("%u distinct tiles; %lu bytes of tiles and map instead of %d\n",
+         ntiles, (unsigned long) (sizeof(tileset) + sizeof(tilemap)),
+         WIDTH * HEIGHT);
+  return 0;
+}
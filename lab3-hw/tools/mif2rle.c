@@ -0,0 +1,148 @@
+/*
+ * Run-length encode the rows of a bitmap MIF
+ *
+ * Reads a MIF of 8-bit RRRGGGBB pixels, row by row, and writes a 16-bit
+ * MIF for the run-length decoder in vga_ball.sv:
+ *
+ *   words 0 .. height-1   the address of each row's first run
+ *   the rest              runs, {color, length - 1}, up to 256 pixels each
+ *
+ * A row's runs cover exactly its width and never continue into the next
+ * row.  Rows identical to an earlier one share its runs.
+ *
+ * Usage: mif2rle [-w width] [-h height] [-d depth] in.mif out.mif
+ *
+ * Only the first height rows of in.mif are encoded; depth is the number
+ * of words in the ROM the output is for.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_PIXELS (640 * 480)
+#define MAX_WORDS 65536
+#define MAX_RUN 256
+
+static unsigned char image[MAX_PIXELS];
+static unsigned int rom[MAX_WORDS];
+static unsigned int width = 640, height = 40, depth = 512;
+
+static void die(const char *msg, const char *name) {
+  fprintf(stderr, "mif2rle: %s: %s\n", name, msg);
+  exit(1);
+}
+
+/*
+ * Read the CONTENT of a MIF: "addr : value;" and "[from..to] : value;"
+ * lines, addresses and values as ADDRESS_RADIX=UNS, DATA_RADIX=HEX
+ */
+static void read_mif(const char *name) {
+  FILE *f = fopen(name, "r");
+  char line[256];
+  unsigned long from, to, a;
+  unsigned int value;
+  int content = 0;
+
+  if (!f)
+    die("cannot open", name);
+  while (fgets(line, sizeof(line), f)) {
+    if (!content) {
+      content = strstr(line, "CONTENT BEGIN") != NULL;
+      continue;
+    }
+    if (sscanf(line, " [%lu..%lu] : %x;", &from, &to, &value) == 3)
+      ;
+    else if (sscanf(line, " %lu : %x;", &from, &value) == 2)
+      to = from;
+    else
+      continue;
+    /* Anything past a 640x480 image is ignored */
+    for (a = from; a <= to && a < MAX_PIXELS; a++)
+      image[a] = value;
+  }
+  fclose(f);
+  if (!content)
+    die("no CONTENT BEGIN", name);
+}
+
+static void write_mif(const char *name, unsigned int words) {
+  FILE *f = fopen(name, "w");
+  unsigned int a;
+
+  if (!f)
+    die("cannot create", name);
+  fprintf(f, "WIDTH=16;\nDEPTH=%u;\nADDRESS_RADIX=UNS;\nDATA_RADIX=HEX;\n"
+          "CONTENT BEGIN\n", depth);
+  for (a = 0; a < words; a++)
+    fprintf(f, "%u : %04X;\n", a, rom[a]);
+  if (words < depth)
+    fprintf(f, "[%u..%u] : 0000;\n", words, depth - 1);
+  fprintf(f, "END;\n");
+  if (fclose(f))
+    die("write failed", name);
+}
+
+int main(int argc, char **argv) {
+  unsigned int y, prev, x, run, words;
+  const unsigned char *row;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "w:h:d:")) != -1)
+    switch (opt) {
+    case 'w':
+      width = strtoul(optarg, NULL, 0);
+      break;
+    case 'h':
+      height = strtoul(optarg, NULL, 0);
+      break;
+    case 'd':
+      depth = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      goto usage;
+    }
+  if (argc - optind != 2)
+    goto usage;
+  if (width == 0 || height == 0 || width * height > MAX_PIXELS)
+    die("bad size", argv[optind]);
+  if (depth > MAX_WORDS)
+    die("depth over 65536", argv[optind + 1]);
+
+  read_mif(argv[optind]);
+
+  words = height;
+  for (y = 0; y < height; y++) {
+    row = image + y * width;
+
+    for (prev = 0; prev < y; prev++)
+      if (memcmp(image + prev * width, row, width) == 0)
+        break;
+    if (prev < y) {
+      rom[y] = rom[prev];
+      continue;
+    }
+
+    rom[y] = words;
+    for (x = 0; x < width; x += run) {
+      for (run = 1; x + run < width && run < MAX_RUN &&
+             row[x + run] == row[x]; run++)
+        ;
+      if (words == depth)
+        die("runs do not fit in depth words", argv[optind + 1]);
+      rom[words++] = row[x] << 8 | (run - 1);
+    }
+  }
+
+  write_mif(argv[optind + 1], words);
+
+  printf("%u words (%u bytes) of %u; %u bytes raw\n",
+         words, words * 2, depth, width * height);
+  return 0;
+
+ usage:
+  fprintf(stderr, "usage: %s [-w width] [-h height] [-d depth] "
+          "in.mif out.mif\n", argv[0]);
+  exit(1);
+}
@@ -0,0 +1,107 @@
+/*
+ * Pack sprite images into the sprite sheet
+ *
+ * Reads one MIF per image (8-bit RRRGGGBB pixels, row by row, 0 for
+ * transparent), places them one after another, and writes sprites.mif
+ * for the sprite sheet RAM in vga_ball.sv.  For each image it prints the
+ * image table entry, {height, width, base}, that shows it; the reset
+ * values of the table in vga_ball.sv must match.
+ *
+ * Usage: mksheet sprites.mif WIDTHxHEIGHT:image.mif ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHEET_SIZE 16384                /* Bytes of sprite sheet */
+#define MAX_SIDE 255                    /* Widths and heights are 8 bits */
+
+static unsigned char sheet[SHEET_SIZE];
+
+static void die(const char *msg, const char *name) {
+  fprintf(stderr, "mksheet: %s: %s\n", name, msg);
+  exit(1);
+}
+
+/*
+ * Read the CONTENT of a MIF of size pixels into pixels: "addr : value;"
+ * and "[from..to] : value;" lines, ADDRESS_RADIX=UNS, DATA_RADIX=HEX
+ */
+static void read_mif(const char *name, unsigned char *pixels,
+                     unsigned long size) {
+  FILE *f = fopen(name, "r");
+  char line[256];
+  unsigned long from, to, a;
+  unsigned int value;
+  int content = 0;
+
+  if (!f)
+    die("cannot open", name);
+  while (fgets(line, sizeof(line), f)) {
+    if (!content) {
+      content = strstr(line, "CONTENT BEGIN") != NULL;
+      continue;
+    }
+    if (sscanf(line, " [%lu..%lu] : %x;", &from, &to, &value) == 3)
+      ;
+    else if (sscanf(line, " %lu : %x;", &from, &value) == 2)
+      to = from;
+    else
+      continue;
+    if (to >= size)
+      die("more pixels than WIDTHxHEIGHT", name);
+    for (a = from; a <= to; a++)
+      pixels[a] = value;
+  }
+  fclose(f);
+  if (!content)
+    die("no CONTENT BEGIN", name);
+}
+
+/* Write the sheet, of which the first used bytes hold images */
+static void write_mif(const char *name, unsigned long used) {
+  FILE *f = fopen(name, "w");
+  unsigned long a;
+
+  if (!f)
+    die("cannot create", name);
+  fprintf(f, "WIDTH=8;\nDEPTH=%d;\nADDRESS_RADIX=UNS;\nDATA_RADIX=HEX;\n"
+          "CONTENT BEGIN\n", SHEET_SIZE);
+  for (a = 0; a < used; a++)
+    fprintf(f, "%lu : %02X;\n", a, sheet[a]);
+  if (used < SHEET_SIZE)
+    fprintf(f, "[%lu..%d] : 00;\n", used, SHEET_SIZE - 1);
+  fprintf(f, "END;\n");
+  if (fclose(f))
+    die("write failed", name);
+}
+
+int main(int argc, char **argv) {
+  unsigned int width, height, base = 0;
+  int i, n;
+
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s sprites.mif WIDTHxHEIGHT:image.mif ...\n",
+            argv[0]);
+    exit(1);
+  }
+
+  for (i = 2; i < argc; i++) {
+    if (sscanf(argv[i], "%ux%u:%n", &width, &height, &n) != 2)
+      die("expected WIDTHxHEIGHT:image.mif", argv[i]);
+    if (width == 0 || height == 0 || width > MAX_SIDE || height > MAX_SIDE)
+      die("sides must be 1 to 255", argv[i]);
+    if (base + width * height > SHEET_SIZE)
+      die("sheet full", argv[i] + n);
+    read_mif(argv[i] + n, sheet + base, width * height);
+    printf("image %d: base %u, %ux%u (%s)\n", i - 2, base, width, height,
+           argv[i] + n);
+    base += width * height;
+  }
+
+  write_mif(argv[1], base);
+
+  printf("%u of %d bytes used\n", base, SHEET_SIZE);
+  return 0;
+}
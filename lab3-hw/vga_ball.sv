@@ -1,10 +1,22 @@
 module vga_ball(
     input logic        clk,
     input logic        reset,
-    input logic [7:0]  writedata,
-    input logic        write,
-    input              chipselect,
-    input logic [2:0]  address,
+    input logic [31:0]  writedata,
+    input logic         write,
+    input logic         read,
+    input               chipselect,
+    input logic [7:0]   address,
+    output logic [31:0] readdata,
+
+    output logic       irq,
+
+    // Avalon-MM master for the background DMA (to the HPS f2h bridge)
+    output logic [31:0] dma_address,
+    output logic [5:0]  dma_burstcount,
+    output logic        dma_read,
+    input logic [31:0]  dma_readdata,
+    input logic         dma_waitrequest,
+    input logic         dma_readdatavalid,
 
     output logic [7:0] VGA_R, VGA_G, VGA_B,
     output logic       VGA_CLK, VGA_HS, VGA_VS,
@@ -27,16 +39,19 @@ module vga_ball(
     logic [1:0] bird_frame;
     logic [23:0] animation_counter;
 
-    logic [18:0] bg_addr;
     logic [7:0]  bg_color;
+    logic [7:0]  tile;          // Tile number at the composed position
+    logic [5:0]  tile_pixel;    // {row, column} within the tile
+    logic [13:0] tileset_addr;
+    logic [7:0]  dma_color;     // Background pixel fetched from HPS memory
+    logic        bg_from_dma;   // Composer draws the line from dma_color
+    logic [23:0] active_bg;     // Sky color {blue, green, red} (REG_BG)
 
-    logic [11:0] bird_addr;
-    logic [7:0]  bird_color;
+    logic [9:0]  sprite_pixel;  // {priority, color} of the top sprite
 
     logic [9:0] scroll_offset;
     logic [23:0] scroll_counter;
 
-    logic [7:0] bird_color_reg;
     logic collision;
 	 logic game_over;
     
@@ -49,8 +64,7 @@ module vga_ball(
     parameter GAMEOVER_X = 320 - GAMEOVER_WIDTH/2;
     parameter GAMEOVER_Y = 240 - GAMEOVER_HEIGHT/2;
     
-    logic [15:0] gameover_addr;
-    logic [7:0]  gameover_color;
+    logic [7:0]  ground_color;
 
     // === Score Display Start ===
     localparam DIGIT_WIDTH  = 16;
@@ -77,9 +91,121 @@ module vga_ball(
     parameter TEST_INTERVAL = 50_000_000;
     
     logic signed [9:0] bird_velocity;
-    logic        vsync_reg, flap_latched;
+    logic        vsync_reg;
     logic [31:0] test_counter;
 
+    // === Register map (32-bit words; byte offset = 4 * address) ===
+    // Keep in step with FB_sw/vga_ball_regs.h
+    localparam logic [7:0] REG_BG             = 8'h00, // {blue, green, red}
+                           REG_BALL           = 8'h01, // {y[25:16], x[9:0]}
+                           REG_FLAP           = 8'h02,
+                           REG_IRQ_ENABLE     = 8'h03,
+                           REG_IRQ_ACK        = 8'h04,
+                           REG_COMMIT         = 8'h05,
+                           REG_CMD_FIFO       = 8'h06, // write only
+                           REG_TILEMAP_ADDR   = 8'h07,
+                           REG_TILEMAP_DATA   = 8'h08, // write only
+                           REG_DMA_BASE       = 8'h09,
+                           REG_DMA_CTRL       = 8'h0A,
+                           REG_SHEET_ADDR     = 8'h0B,
+                           REG_SHEET_DATA     = 8'h0C, // write only
+                           REG_STATUS         = 8'h10, // read only from here
+                           REG_BIRD_Y         = 8'h11,
+                           REG_PIPE0          = 8'h12, // three words
+                           REG_FLAP_COUNTS    = 8'h15,
+                           REG_FRAME          = 8'h16,
+                           REG_VSYNC_CYCLES   = 8'h17,
+                           REG_CYCLES_LO      = 8'h18,
+                           REG_CYCLES_HI      = 8'h19,
+                           REG_ACTIVE_BG      = 8'h1C,
+                           REG_ACTIVE_BALL    = 8'h1D,
+                           REG_COMMIT_PENDING = 8'h1E,
+                           REG_CMD_LEVEL      = 8'h1F,
+                           REG_CMD_OVERFLOWS  = 8'h20,
+                           REG_EVENTS         = 8'h21, // read clears
+                           REG_DMA_UNDERRUNS  = 8'h22,
+                           REG_SPRITE_DROPS   = 8'h23,
+                           REG_DMA_BUSY       = 8'h24,
+                           REG_SPRITE0        = 8'h40, // read/write tables
+                           REG_IMAGE0         = 8'h60;
+
+    logic reg_write;
+    assign reg_write = chipselect && write;
+
+    // === Command FIFO ===
+    // Each write to REG_CMD_FIFO pushes one {opcode[31:24], payload[23:0]}
+    // command; a push that finds the FIFO full is dropped and counted.
+    // On each VS edge the commands queued so far are executed, one per
+    // cycle, during vertical blanking; later pushes wait for the next
+    // frame.  Draining pauses on any cycle the bus writes a register, so
+    // a command never collides with a direct write to the same register.
+    localparam CMD_DEPTH = 64;
+    localparam logic [7:0] CMD_SET_BG   = 8'h01, // payload {blue, green, red}
+                           CMD_SET_BALL = 8'h02, // payload {y[19:10], x[9:0]}
+                           CMD_FLAP     = 8'h03,
+                           CMD_COMMIT   = 8'h04; // shadow to active at once
+
+    logic [31:0] cmd_mem[CMD_DEPTH];
+    logic [5:0]  cmd_head, cmd_tail;
+    logic [6:0]  cmd_level, cmd_to_run;
+    logic [31:0] cmd_overflows;
+    logic        cmd_push, cmd_exec;
+    logic [7:0]  cmd_op;
+    logic [23:0] cmd_payload;
+
+    assign cmd_push    = reg_write && address == REG_CMD_FIFO;
+    assign cmd_exec    = cmd_to_run != 7'd0 && !reg_write;
+    assign cmd_op      = cmd_mem[cmd_head][31:24];
+    assign cmd_payload = cmd_mem[cmd_head][23:0];
+
+    always_ff @(posedge clk) begin
+        if (cmd_push && cmd_level != CMD_DEPTH)
+            cmd_mem[cmd_tail] <= writedata;
+    end
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            cmd_head      <= 6'd0;
+            cmd_tail      <= 6'd0;
+            cmd_level     <= 7'd0;
+            cmd_to_run    <= 7'd0;
+            cmd_overflows <= 32'd0;
+        end else begin
+            // Pushes and executions never share a cycle (see cmd_exec)
+            if (cmd_push) begin
+                if (cmd_level == CMD_DEPTH)
+                    cmd_overflows <= cmd_overflows + 32'd1;
+                else begin
+                    cmd_tail  <= cmd_tail + 6'd1;
+                    cmd_level <= cmd_level + 7'd1;
+                end
+            end else if (cmd_exec) begin
+                cmd_head  <= cmd_head + 6'd1;
+                cmd_level <= cmd_level - 7'd1;
+            end
+
+            if (VGA_VS && !vsync_reg)
+                cmd_to_run <= cmd_exec ? cmd_level - 7'd1 : cmd_level;
+            else if (cmd_exec)
+                cmd_to_run <= cmd_to_run - 7'd1;
+        end
+    end
+
+    // === Flap requests ===
+    // Each write of 1 to REG_FLAP, or CMD_FLAP, queues one flap.  Queued flaps are
+    // consumed one per physics tick while PLAYING (and one to leave
+    // WAITING or GAME_OVER), so presses within one frame are not lost;
+    // a write that finds the queue full is counted as dropped.  The
+    // queue is emptied on the clock after entering or leaving GAME_OVER,
+    // so flaps left over from one game cannot restart the next; the
+    // flaps emptied are counted as dropped too.
+    localparam FLAP_QUEUE_MAX = 3'd7;
+
+    logic [2:0]  flap_pending;
+    logic [15:0] flaps_received, flaps_dropped;
+    logic        flap_write, flap_ready, flap_take, flap_flush;
+    game_state_t prev_state;  // game_state on the previous clock
+
     vga_counters counters (
         .clk50(clk),
         .reset(reset),
@@ -92,16 +218,8 @@ module vga_ball(
         .VGA_SYNC_n(VGA_SYNC_n)
     );
 	 
-    bg_rom    bg_rom_inst (.address(bg_addr), .clock(clk), .q(bg_color));
-    bird_rom0 bird0       (.address(bird_addr), .clock(clk), .q(bird_color0));
-    bird_rom1 bird1       (.address(bird_addr), .clock(clk), .q(bird_color1));
-    bird_rom2 bird2       (.address(bird_addr), .clock(clk), .q(bird_color2));
-	 
-	 gameover_rom gameover_inst (.address(gameover_addr), .clock(clk), .q(gameover_color));
-	 
+    tileset_rom tileset   (.address(tileset_addr), .clock(clk), .q(bg_color));
 
-    logic [7:0] bird_color0, bird_color1, bird_color2;
-    
     function automatic bit in_rect(
         input int x0, input int y0,
         input int W,  input int H,
@@ -112,37 +230,493 @@ module vga_ball(
                    vc >= y0 && vc < y0 + H);
     endfunction
 
+    // === Scanline composer ===
+    // Each line is drawn into a line buffer during the line before it, one
+    // pixel per clock, and scanout only reads the buffer back.  There are
+    // two buffers, picked by the low bit of the row, so one fills while the
+    // other is shown.  The composer starts at hcount 0 with pixel (cx, cy)
+    // and needs 640 clocks plus COMPOSE_LATENCY, well inside the 1600-clock
+    // line; the layers' ROMs all answer COMPOSE_LATENCY clocks after their
+    // address, and the rest of each pixel is carried along to meet them.
+    localparam COMPOSE_LATENCY = 2;
+    localparam LAYER_SCORE    = 0,
+               LAYER_BALL     = 1,
+               LAYER_PIPE     = 2,
+               LAYER_GROUND   = 3;
+    localparam logic [7:0] SKY_COLOR = 8'hD9; // Tile pixels drawn in active_bg
+
+    logic [9:0]  cx, cy;        // Pixel whose addresses go out this clock
+    logic        composing;
+    logic [3:0]  layers;        // Which layers cover (cx, cy)
+    logic [9:0]  compose_x      [1:COMPOSE_LATENCY];
+    logic [3:0]  compose_layers [1:COMPOSE_LATENCY];
+    logic        compose_valid  [1:COMPOSE_LATENCY];
+    logic [3:0]  out_layers;
+    logic [23:0] line_wdata;
+    logic        sprite_on;
+    logic [1:0]  sprite_priority;
+    logic [23:0] sprite_rgb;
+    logic [23:0] line_buf [0:2047]; // {row[0], column}
+    logic [23:0] line_pixel;
+
+    assign cy = vcount == 10'd524 ? 10'd0 : vcount + 10'd1;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            composing <= 1'b0;
+            cx        <= 10'd0;
+        end else if (hcount == 11'd0) begin
+            composing <= cy < 10'd480;
+            cx        <= 10'd0;
+        end else if (composing) begin
+            if (cx == 10'd639)
+                composing <= 1'b0;
+            cx <= cx + 10'd1;
+        end
+    end
+
     always_ff @(posedge clk) begin
-        case (bird_frame)
-            2'd0: bird_color_reg <= bird_color0;
-            2'd1: bird_color_reg <= bird_color1;
-            2'd2: bird_color_reg <= bird_color2;
-            default: bird_color_reg <= bird_color0;
-        endcase
+        compose_x[1]      <= cx;
+        compose_layers[1] <= layers;
+        compose_valid[1]  <= composing;
+        for (int s = 2; s <= COMPOSE_LATENCY; s++) begin
+            compose_x[s]      <= compose_x[s-1];
+            compose_layers[s] <= compose_layers[s-1];
+            compose_valid[s]  <= compose_valid[s-1];
+        end
     end
 
+    // Layers front to back.  Sprites sit at one of three depths by their
+    // priority (see Sprites); sprite color 0 is no sprite.
+    assign out_layers      = compose_layers[COMPOSE_LATENCY];
+    assign sprite_on       = sprite_pixel[7:0] != 8'h00;
+    assign sprite_priority = sprite_pixel[9:8];
+    assign sprite_rgb      = {sprite_pixel[7:5], 5'b00000,
+                              sprite_pixel[4:2], 5'b00000,
+                              sprite_pixel[1:0], 6'b000000};
+
     always_comb begin
-        logic [9:0] bg_col;
-		  bg_col = (hcount[10:1] + scroll_offset) % 640;
-		  bg_addr = vcount * 640 + bg_col;
-		  /*
-        bg_col = (hcount[10:1] + scroll_offset);
-        if(bg_col < 640)
-            bg_addr = vcount * 640 + bg_col;
+        if (sprite_on && sprite_priority >= 2'd2)
+            line_wdata = sprite_rgb;
+        else if (out_layers[LAYER_SCORE])
+            line_wdata = 24'hFFFFFF;
+        else if (out_layers[LAYER_BALL])
+            line_wdata = 24'hFFFFFF;
+        else if (sprite_on && sprite_priority == 2'd1)
+            line_wdata = sprite_rgb;
+        else if (out_layers[LAYER_PIPE])
+            line_wdata = 24'h00FF00;
+        else if (out_layers[LAYER_GROUND])
+            line_wdata = {ground_color[7:5], 5'b00000,
+                          ground_color[4:2], 5'b00000,
+                          ground_color[1:0], 6'b000000};
+        else if (sprite_on)
+            line_wdata = sprite_rgb;
+        else if (bg_from_dma) // Backgrounds store blue in the top bits
+            line_wdata = {dma_color[1:0], 6'b000000,
+                          dma_color[4:2], 5'b00000,
+                          dma_color[7:5], 5'b00000};
+        else if (bg_color == SKY_COLOR)
+            line_wdata = {active_bg[7:0], active_bg[15:8], active_bg[23:16]};
         else
-            bg_addr = vcount * 640 + (bg_col - 640);
-			*/
+            line_wdata = {bg_color[1:0], 6'b000000,
+                          bg_color[4:2], 5'b00000,
+                          bg_color[7:5], 5'b00000};
+    end
 
-        if (hcount[10:1] >= BIRD_X && hcount[10:1] < BIRD_X + BIRD_WIDTH &&
-            vcount >= bird_y && vcount < bird_y + BIRD_HEIGHT)
-            bird_addr = (vcount - bird_y) * BIRD_WIDTH + (hcount[10:1] - BIRD_X);
-        else
-            bird_addr = 0;
-		
-		  if (in_rect(GAMEOVER_X, GAMEOVER_Y, GAMEOVER_WIDTH, GAMEOVER_HEIGHT, hcount[10:1], vcount))
-            gameover_addr = (vcount - GAMEOVER_Y) * GAMEOVER_WIDTH + (hcount[10:1] - GAMEOVER_X);
-        else
-            gameover_addr = 0;
+    always_ff @(posedge clk) begin
+        if (compose_valid[COMPOSE_LATENCY])
+            line_buf[{cy[0], compose_x[COMPOSE_LATENCY]}] <= line_wdata;
+        line_pixel <= line_buf[{vcount[0], hcount[10:1]}];
+    end
+
+    // === Tiled background ===
+    // The 640x480 background is an 80x60 map of 8x8 tiles: tilemap holds a
+    // tile number for each position and tileset_rom 64 pixels for each
+    // tile, both built from bg.mif by tools/bg2tiles.  The map is read a
+    // cycle before the tile, so the color arrives COMPOSE_LATENCY cycles
+    // after cx, like the other layers' ROMs.
+    localparam TILEMAP_WIDTH = 80,
+               TILEMAP_SIZE  = 4800;
+
+    (* ram_init_file = "tilemap.mif" *)
+    logic [7:0]  tilemap [0:TILEMAP_SIZE-1];
+    logic [9:0]  bg_col;
+    logic [12:0] tilemap_raddr, tilemap_waddr;
+
+    assign bg_col        = (cx + scroll_offset) % 640;
+    assign tilemap_raddr = cy[8:3] * TILEMAP_WIDTH + bg_col[9:3];
+    assign tileset_addr  = {tile, tile_pixel};
+
+    always_ff @(posedge clk) begin
+        if (reg_write && address == REG_TILEMAP_DATA)
+            tilemap[tilemap_waddr] <= writedata[7:0];
+        tile       <= tilemap[tilemap_raddr];
+        tile_pixel <= {cy[2:0], bg_col[2:0]};
+    end
+
+    // Software rewrites the map by setting a position in REG_TILEMAP_ADDR,
+    // then writing tile numbers to REG_TILEMAP_DATA, which steps along the
+    // row (and on to the next).  Changes show up at once, not at vsync.
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset)
+            tilemap_waddr <= 13'd0;
+        else if (reg_write && address == REG_TILEMAP_ADDR)
+            tilemap_waddr <= writedata[12:0];
+        else if (reg_write && address == REG_TILEMAP_DATA)
+            tilemap_waddr <= tilemap_waddr == TILEMAP_SIZE - 1 ?
+                             13'd0 : tilemap_waddr + 13'd1;
+    end
+
+    // === Background DMA ===
+    // With REG_DMA_CTRL bit 0 set, the background comes from a 640x480
+    // frame of bytes (the tile set's format) at REG_DMA_BASE in HPS
+    // memory instead of the tiles.  Both are taken at the VS edge, so a
+    // new base, or going back to the tiles, swaps the whole frame at
+    // once.  Writing bit 1 (stop) instead turns the DMA off at once, for
+    // when the memory is about to go: no new burst is requested, and
+    // REG_DMA_BUSY reads 1 until the bursts already requested are in.
+    // During each line the master bursts row vcount + 2 into one half of
+    // a double-buffered line RAM; the composer reads row vcount + 1 from
+    // the other half on the next line.  A row that is not all in when its
+    // composing starts is drawn from the tiles instead and counted in
+    // REG_DMA_UNDERRUNS.
+    localparam DMA_LINE_WORDS = 160,    // 640 pixels, four to a word
+               DMA_BURST      = 32;
+    localparam DMA_CTRL_ENABLE = 0,
+               DMA_CTRL_STOP   = 1;
+
+    logic [31:0] dma_base, dma_frame_base;
+    logic        dma_enable, dma_frame_enable;
+    logic [9:0]  fetch_y;               // Row fetched during this line
+    logic        dma_fetching;
+    logic        dma_stalled;           // dma_read held by waitrequest
+    logic        dma_fetch_buf;         // Line RAM half being filled
+    logic [31:0] dma_line_addr;
+    logic [7:0]  dma_issued, dma_received;  // Words
+    logic [1:0]  dma_line_ok;           // Half holds a whole row
+    logic [31:0] dma_underruns;
+    logic [31:0] dma_line [0:511];      // {half, word}
+    logic [31:0] dma_word;
+    logic [1:0]  dma_byte;
+
+    assign fetch_y = vcount >= 10'd523 ? vcount - 10'd523 : vcount + 10'd2;
+
+    assign dma_address    = dma_line_addr + {22'd0, dma_issued, 2'b00};
+    assign dma_burstcount = DMA_BURST;
+    // Avalon needs read held until the slave takes it, even once stopped
+    assign dma_read       = dma_stalled || (dma_fetching && dma_frame_enable &&
+                                            dma_issued != DMA_LINE_WORDS);
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            dma_base         <= 32'd0;
+            dma_enable       <= 1'b0;
+            dma_frame_base   <= 32'd0;
+            dma_frame_enable <= 1'b0;
+            dma_fetching     <= 1'b0;
+            dma_stalled      <= 1'b0;
+            dma_fetch_buf    <= 1'b0;
+            dma_line_addr    <= 32'd0;
+            dma_issued       <= 8'd0;
+            dma_received     <= 8'd0;
+            dma_line_ok      <= 2'b00;
+            dma_underruns    <= 32'd0;
+            bg_from_dma      <= 1'b0;
+        end else begin
+            if (reg_write && address == REG_DMA_BASE)
+                dma_base <= writedata;
+            if (reg_write && address == REG_DMA_CTRL)
+                dma_enable <= writedata[DMA_CTRL_ENABLE] &&
+                              !writedata[DMA_CTRL_STOP];
+            if (reg_write && address == REG_DMA_CTRL &&
+                writedata[DMA_CTRL_STOP])
+                dma_frame_enable <= 1'b0;   // Off at once, so memory can go
+            else if (VGA_VS && !vsync_reg) begin
+                dma_frame_base   <= dma_base;
+                dma_frame_enable <= dma_enable;
+            end
+
+            dma_stalled <= dma_read && dma_waitrequest;
+            if (dma_read && !dma_waitrequest)
+                dma_issued <= dma_issued + DMA_BURST;
+            if (dma_readdatavalid) begin
+                dma_received <= dma_received + 8'd1;
+                if (dma_received == DMA_LINE_WORDS - 1) begin
+                    dma_fetching <= 1'b0;
+                    dma_line_ok[dma_fetch_buf] <= 1'b1;
+                end
+            end else if (dma_fetching && !dma_frame_enable && !dma_read &&
+                         dma_received == dma_issued) begin
+                // Stopped part way: what was requested is in, so the row
+                // ends here, incomplete
+                dma_fetching <= 1'b0;
+            end
+
+            if (hcount == 11'd0) begin
+                // Start this line's row, unless the last one is still
+                // arriving; either way the half it goes in is not ready
+                if (dma_frame_enable && fetch_y < 10'd480) begin
+                    dma_line_ok[fetch_y[0]] <= 1'b0;
+                    if (!dma_fetching) begin
+                        dma_fetching  <= 1'b1;
+                        dma_fetch_buf <= fetch_y[0];
+                        dma_line_addr <= dma_frame_base + fetch_y * 640;
+                        dma_issued    <= 8'd0;
+                        dma_received  <= 8'd0;
+                    end
+                end
+
+                bg_from_dma <= dma_frame_enable && dma_line_ok[cy[0]];
+                if (dma_frame_enable && cy < 10'd480 && !dma_line_ok[cy[0]])
+                    dma_underruns <= dma_underruns + 32'd1;
+            end
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (dma_readdatavalid)
+            dma_line[{dma_fetch_buf, dma_received}] <= dma_readdata;
+        // COMPOSE_LATENCY: word, then the byte of it, as for the tiles
+        dma_word  <= dma_line[{cy[0], bg_col[9:2]}];
+        dma_byte  <= bg_col[1:0];
+        dma_color <= dma_word[8 * dma_byte +: 8];
+    end
+
+    // === Sprites ===
+    // SPRITES sprites share one 16 KB sprite sheet.  Each shows an image,
+    // picked by its frame number from the image table ({height, width,
+    // base} of an area of the sheet), with its top left corner at (x, y),
+    // either of which may be negative.  Its priority puts it behind the
+    // pipes and ground (0), in front of them but behind the score (1), or
+    // in front of everything (2, 3); color 0 is transparent.  Sprites 0
+    // and 1 are the bird and the game over banner, driven by the game;
+    // software owns the rest and can rewrite the image table and the
+    // sheet.  Every write takes effect from the next row drawn.
+    //
+    // While a line is composed, the sprites of the row after it are drawn
+    // into one half of a double-buffered sprite line, lowest priority
+    // first and in sprite order within a priority, so each covers those
+    // drawn before it.  A sprite costs a clock per priority to look at,
+    // and a clock per pixel of its width on rows it covers.  Sprites not
+    // drawn by the end of the line are dropped for that row, and the row
+    // is counted in REG_SPRITE_DROPS.  The composer reads the other half,
+    // clearing each pixel behind it for the row it will hold next.
+    parameter SPRITES = 16;             // At most 16: see REG_SPRITE0
+    localparam IMAGES     = 16,
+               SHEET_SIZE = 16384,
+               SPRITE_END = 11'd1598;   // hcount drawing stops at
+
+    // Images in sprites.mif, as tools/mksheet lays them out
+    localparam IMAGE_BIRD     = 0,      // Three frames of wing beat
+               IMAGE_GAMEOVER = 3;
+
+    (* ram_init_file = "sprites.mif" *)
+    logic [7:0]  sprite_sheet [0:SHEET_SIZE-1];
+    logic [13:0] sheet_waddr;
+    logic [31:0] sprite_pos  [SPRITES]; // {y[26:16], x[10:0]}
+    logic [31:0] sprite_ctrl [SPRITES]; // {enable, priority[25:24], frame}
+    logic [31:0] image_table [IMAGES];  // {height, width, base[13:0]}
+    logic [31:0] attr_pos  [SPRITES];   // As drawn: sprites 0 and 1 from
+    logic [31:0] attr_ctrl [SPRITES];   // the game, the rest as written
+    logic [31:0] sprite_readdata;
+    logic [31:0] sprite_drops;
+
+    always_comb begin
+        for (int s = 0; s < SPRITES; s++) begin
+            attr_pos[s]  = sprite_pos[s];
+            attr_ctrl[s] = sprite_ctrl[s];
+        end
+        attr_pos[0]  = {5'd0, 1'b0, bird_y, 5'd0, 11'(BIRD_X)};
+        attr_ctrl[0] = {1'b1, 5'd0, 2'd1, 16'd0,
+                        8'(IMAGE_BIRD) + {6'd0, bird_frame}};
+        attr_pos[1]  = {5'd0, 11'(GAMEOVER_Y), 5'd0, 11'(GAMEOVER_X)};
+        attr_ctrl[1] = {game_state == GAME_OVER, 5'd0, 2'd2, 16'd0,
+                        8'(IMAGE_GAMEOVER)};
+    end
+
+    // Software writes.  The sheet is written like the tile map: set
+    // REG_SHEET_ADDR, then each REG_SHEET_DATA write stores a pixel and
+    // steps to the next.
+    always_ff @(posedge clk) begin
+        if (reg_write && address == REG_SHEET_DATA)
+            sprite_sheet[sheet_waddr] <= writedata[7:0];
+    end
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            for (int s = 0; s < SPRITES; s++) begin
+                sprite_pos[s]  <= 32'd0;
+                sprite_ctrl[s] <= 32'd0;
+            end
+            for (int j = 0; j < IMAGES; j++)
+                image_table[j] <= 32'd0;
+            for (int j = 0; j < 3; j++)
+                image_table[IMAGE_BIRD + j] <=
+                    {8'(BIRD_HEIGHT), 8'(BIRD_WIDTH), 2'd0,
+                     14'(j * BIRD_WIDTH * BIRD_HEIGHT)};
+            image_table[IMAGE_GAMEOVER] <=
+                {8'(GAMEOVER_HEIGHT), 8'(GAMEOVER_WIDTH), 2'd0,
+                 14'(3 * BIRD_WIDTH * BIRD_HEIGHT)};
+            sheet_waddr <= 14'd0;
+        end else if (reg_write) begin
+            // Writes to sprites 0 and 1 are stored but not shown
+            if (address >= REG_SPRITE0 &&
+                address < REG_SPRITE0 + 2 * SPRITES) begin
+                if (address[0])
+                    sprite_ctrl[(address - REG_SPRITE0) >> 1] <= writedata;
+                else
+                    sprite_pos[(address - REG_SPRITE0) >> 1] <= writedata;
+            end
+            if (address >= REG_IMAGE0 && address < REG_IMAGE0 + IMAGES)
+                image_table[address - REG_IMAGE0] <= writedata;
+            if (address == REG_SHEET_ADDR)
+                sheet_waddr <= writedata[13:0];
+            else if (address == REG_SHEET_DATA)
+                sheet_waddr <= sheet_waddr + 14'd1;
+        end
+    end
+
+    // Readback of the tables, for the status readback below
+    always_comb begin
+        sprite_readdata = 32'd0;
+        if (address >= REG_SPRITE0 && address < REG_SPRITE0 + 2 * SPRITES)
+            sprite_readdata = address[0] ?
+                              attr_ctrl[(address - REG_SPRITE0) >> 1] :
+                              attr_pos[(address - REG_SPRITE0) >> 1];
+        else if (address >= REG_IMAGE0 && address < REG_IMAGE0 + IMAGES)
+            sprite_readdata = image_table[address - REG_IMAGE0];
+    end
+
+    // The drawing: look at each sprite in turn, and copy the row of
+    // those that cover the row being drawn from the sheet to the line,
+    // a pixel per clock.  Pixels arrive from the sheet a clock after
+    // their address and go into the line then.
+    typedef enum logic [1:0] {
+        SPRITE_IDLE, SPRITE_LOOK, SPRITE_DRAW
+    } sprite_state_t;
+
+    sprite_state_t sprite_state;
+    logic [3:0]  sprite;                // Being looked at or drawn
+    logic [1:0]  sprite_pass;           // Priority being drawn
+    logic [9:0]  sprite_y;              // Row being drawn
+    logic        sprite_half;           // Line half it goes in
+    logic [31:0] look_pos, look_ctrl, look_image;
+    logic [10:0] look_row;              // Row of the image, if it is on it
+    logic        look_hit;
+    logic        look_last;             // Last sprite of the last pass
+    logic [13:0] sheet_raddr;
+    logic [10:0] draw_x;                // Where the pixel read now goes
+    logic [7:0]  draw_left;             // Pixels of the row still to read
+    logic [7:0]  sheet_pixel;
+    logic        put_valid;
+    logic [10:0] put_x;
+    logic [1:0]  put_priority;
+    logic [9:0]  sprite_line0 [0:639];  // {priority, color}
+    logic [9:0]  sprite_line1 [0:639];
+    logic [9:0]  sprite_read;
+
+    assign look_pos   = attr_pos[sprite];
+    assign look_ctrl  = attr_ctrl[sprite];
+    assign look_image = image_table[look_ctrl[3:0]];
+    assign look_row   = {1'b0, sprite_y} - look_pos[26:16];
+    assign look_hit   = look_ctrl[31] && look_ctrl[25:24] == sprite_pass &&
+                        !look_row[10] && look_row < {3'd0, look_image[31:24]} &&
+                        look_image[23:16] != 8'd0;
+    assign look_last  = sprite == SPRITES - 1 && sprite_pass == 2'd3;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            sprite_state <= SPRITE_IDLE;
+            sprite       <= 4'd0;
+            sprite_pass  <= 2'd0;
+            sprite_y     <= 10'd0;
+            sprite_half  <= 1'b0;
+            sheet_raddr  <= 14'd0;
+            draw_x       <= 11'd0;
+            draw_left    <= 8'd0;
+            put_valid    <= 1'b0;
+            put_x        <= 11'd0;
+            put_priority <= 2'd0;
+            sprite_drops <= 32'd0;
+        end else begin
+            put_valid    <= sprite_state == SPRITE_DRAW;
+            put_x        <= draw_x;
+            put_priority <= sprite_pass;
+
+            if (hcount == 11'd0) begin
+                // The row the next line composes, as the DMA fetches
+                if (fetch_y < 10'd480) begin
+                    sprite_state <= SPRITE_LOOK;
+                    sprite       <= 4'd0;
+                    sprite_pass  <= 2'd0;
+                    sprite_y     <= fetch_y;
+                    sprite_half  <= fetch_y[0];
+                end
+            end else if (hcount == SPRITE_END) begin
+                if (sprite_state != SPRITE_IDLE)
+                    sprite_drops <= sprite_drops + 32'd1;
+                sprite_state <= SPRITE_IDLE;
+            end else
+                case (sprite_state)
+                    SPRITE_LOOK:
+                        if (look_hit) begin
+                            sheet_raddr  <= look_image[13:0] +
+                                            look_row[7:0] * look_image[23:16];
+                            draw_x       <= look_pos[10:0];
+                            draw_left    <= look_image[23:16];
+                            sprite_state <= SPRITE_DRAW;
+                        end else begin
+                            sprite <= sprite + 4'd1;
+                            if (sprite == SPRITES - 1) begin
+                                sprite      <= 4'd0;
+                                sprite_pass <= sprite_pass + 2'd1;
+                            end
+                            if (look_last)
+                                sprite_state <= SPRITE_IDLE;
+                        end
+                    SPRITE_DRAW: begin
+                        sheet_raddr <= sheet_raddr + 14'd1;
+                        draw_x      <= draw_x + 11'd1;
+                        draw_left   <= draw_left - 8'd1;
+                        if (draw_left == 8'd1) begin
+                            sprite       <= sprite + 4'd1;
+                            sprite_state <= SPRITE_LOOK;
+                            if (sprite == SPRITES - 1) begin
+                                sprite      <= 4'd0;
+                                sprite_pass <= sprite_pass + 2'd1;
+                            end
+                            if (look_last)
+                                sprite_state <= SPRITE_IDLE;
+                        end
+                    end
+                    default: ;
+                endcase
+        end
+    end
+
+    // Sprite line halves: each is written by the drawing or, while the
+    // composer reads it, cleared a pixel behind the composer.  The
+    // composer's pixel arrives COMPOSE_LATENCY clocks after cx.
+    logic put_write, clear_write;
+    assign put_write   = put_valid && sheet_pixel != 8'h00 &&
+                         !put_x[10] && put_x < 11'd640;
+    assign clear_write = compose_valid[1];
+
+    always_ff @(posedge clk) begin
+        sheet_pixel <= sprite_sheet[sheet_raddr];
+
+        if (put_write && !sprite_half)
+            sprite_line0[put_x[9:0]] <= {put_priority, sheet_pixel};
+        else if (clear_write && !cy[0])
+            sprite_line0[compose_x[1]] <= 10'd0;
+        if (put_write && sprite_half)
+            sprite_line1[put_x[9:0]] <= {put_priority, sheet_pixel};
+        else if (clear_write && cy[0])
+            sprite_line1[compose_x[1]] <= 10'd0;
+
+        sprite_read  <= cy[0] ? sprite_line1[cx] : sprite_line0[cx];
+        sprite_pixel <= sprite_read;
     end
 
     //管道结构参数（周日晚调试，左侧柱子左边触边缘 就立刻消失）
@@ -173,12 +747,42 @@ module vga_ball(
             lfsr <= {lfsr[6:0], lfsr[7] ^ lfsr[5]};
     end
 
+    assign flap_write = (reg_write && address == REG_FLAP && writedata[0]) ||
+                        (cmd_exec && cmd_op == CMD_FLAP);
+    assign flap_flush = game_state != prev_state &&
+                        (game_state == GAME_OVER || prev_state == GAME_OVER);
+    assign flap_ready = flap_pending != 3'd0 && !flap_flush;
+    assign flap_take  = flap_ready &&
+                        (game_state != PLAYING || (VGA_VS && !vsync_reg));
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            flap_pending   <= 3'd0;
+            flaps_received <= 16'd0;
+            flaps_dropped  <= 16'd0;
+        end else begin
+            if (flap_write)
+                flaps_received <= flaps_received + 16'd1;
+
+            if (flap_flush) begin
+                flap_pending  <= {2'b0, flap_write};
+                flaps_dropped <= flaps_dropped + {13'd0, flap_pending};
+            end else if (flap_write && !flap_take) begin
+                if (flap_pending == FLAP_QUEUE_MAX)
+                    flaps_dropped <= flaps_dropped + 16'd1;
+                else
+                    flap_pending <= flap_pending + 3'd1;
+            end else if (!flap_write && flap_take) begin
+                flap_pending <= flap_pending - 3'd1;
+            end
+        end
+    end
+
     always_ff @(posedge clk or posedge reset) begin
         if (reset) begin
             bird_y <= 240;
             bird_velocity <= 0;
             vsync_reg <= 1'b0;
-            flap_latched <= 1'b0;
             test_counter <= 32'd0;
             
             bird_frame <= 0;
@@ -196,15 +800,6 @@ module vga_ball(
             // Vertical sync edge detection
             vsync_reg <= VGA_VS;
             
-            // Handle keyboard input (flapping)
-            if (chipselect && write && address == 3'h7) begin
-                // Register flap command from processor
-                flap_latched <= writedata[0];
-            end else if (VGA_VS && !vsync_reg && flap_latched) begin
-                // Clear flap signal after frame update
-                flap_latched <= 0;
-            end
-            
             // Animation counter for bird wings always updates
 				if (game_state != GAME_OVER) begin
 					animation_counter <= animation_counter + 1;
@@ -246,7 +841,7 @@ module vga_ball(
                     end
                     
                     // Start game on flap
-                    if (flap_latched) begin
+                    if (flap_ready) begin
                         game_state <= PLAYING;
                         bird_velocity <= FLAP_STRENGTH; // Initial upward velocity
                     end
@@ -257,7 +852,7 @@ module vga_ball(
                     if (VGA_VS && !vsync_reg) begin
 								
                         // Flap or apply gravity
-                        if (flap_latched) begin 
+                        if (flap_ready) begin
 									bird_velocity <= FLAP_STRENGTH; // Upward velocity
                         end else begin
                             bird_velocity <= bird_velocity + GRAVITY;
@@ -321,25 +916,350 @@ module vga_ball(
 						  bird_y <= bird_y;
                     
                     // Wait for flap to restart
-                    if (flap_latched) begin
+                    if (flap_ready) begin
                         game_state <= WAITING;
-								flap_latched <= 0;
                     end
                 end
             endcase
         end
     end
 
-    logic [15:0] ground_addr;
-    logic [7:0]  ground_color;
+    // === Vsync interrupt ===
+    // Raised on the same VS edge that steps the game; REG_IRQ_ENABLE bit 0
+    // enables it, any write to REG_IRQ_ACK acknowledges it
+    logic irq_enable, irq_pending;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            irq_enable  <= 1'b0;
+            irq_pending <= 1'b0;
+        end else begin
+            if (reg_write && address == REG_IRQ_ENABLE)
+                irq_enable <= writedata[0];
+
+            if (VGA_VS && !vsync_reg)
+                irq_pending <= 1'b1;
+            else if (reg_write && address == REG_IRQ_ACK)
+                irq_pending <= 1'b0;
+        end
+    end
+
+    assign irq = irq_enable & irq_pending;
+
+    // === Game events ===
+    // Sticky flags set when the score goes up, when a game ends in a
+    // collision (with a pipe or the ground), and on every game state
+    // change.  All of them happen on or just after the VS edge that steps
+    // the game, well before the vsync interrupt is serviced.  Reading
+    // REG_EVENTS returns {score, 6'b0, game_state, 5'b0, flags} and
+    // clears the flags; a flag raised on that same cycle is kept.
+    localparam EVENT_SCORE     = 0,
+               EVENT_COLLISION = 1,
+               EVENT_STATE     = 2;
+
+    logic [2:0]  events, events_now;
+    logic [15:0] prev_score;
+    logic        events_read;
+
+    assign events_now[EVENT_SCORE]     = score > prev_score;
+    assign events_now[EVENT_COLLISION] = prev_state == PLAYING &&
+                                         game_state == GAME_OVER;
+    assign events_now[EVENT_STATE]     = game_state != prev_state;
+    assign events_read = chipselect && read && address == REG_EVENTS;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            events     <= 3'd0;
+            prev_score <= 16'd0;
+            prev_state <= WAITING;
+        end else begin
+            prev_score <= score;
+            prev_state <= game_state;
+            events <= (events_read ? 3'd0 : events) | events_now;
+        end
+    end
+
+    // === Frame and cycle counters ===
+    // frame_count steps on the VS edge that steps the game; vsync_cycles
+    // is the low word of cycle_count at that edge
+    logic [31:0] frame_count, vsync_cycles;
+    logic [63:0] cycle_count;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            frame_count  <= 32'd0;
+            vsync_cycles <= 32'd0;
+            cycle_count  <= 64'd0;
+        end else begin
+            cycle_count <= cycle_count + 64'd1;
+            if (VGA_VS && !vsync_reg) begin
+                frame_count  <= frame_count + 32'd1;
+                vsync_cycles <= cycle_count[31:0];
+            end
+        end
+    end
 
-    base_rom ground_inst (.address(ground_addr), .clock(clk), .q(ground_color));
+    // === Display registers (double-buffered) ===
+    // Writes to REG_BG and REG_BALL (or CMD_SET_BG and CMD_SET_BALL) land
+    // in the shadow set.  Writing REG_COMMIT copies the whole shadow set
+    // to the active set in one cycle: bit 0 arms the copy for the next VS
+    // edge, bit 1 copies at once, as does CMD_COMMIT.  The composer draws
+    // from the active set: the background's sky pixels in active_bg, and
+    // a white ball of BALL_RADIUS centered on the active ball position,
+    // hidden while its x is off the screen (as it is after reset).  A VS
+    // edge falls after the last visible line is composed, so a copy there
+    // never shows half a frame.
+    localparam BALL_RADIUS = 8;
+
+    logic [23:0] shadow_bg;                  // {blue, green, red}
+    logic [9:0]  shadow_ball_x, shadow_ball_y;
+    logic [9:0]  active_ball_x, active_ball_y;
+    logic        commit_pending;
+    logic        commit_now, commit_vsync;
+    logic signed [10:0] ball_dx, ball_dy;    // (cx, cy) from the ball
+    logic        ball_pixel;
+
+    assign commit_now   = (reg_write && address == REG_COMMIT && writedata[1]) ||
+                          (cmd_exec && cmd_op == CMD_COMMIT);
+    assign commit_vsync = commit_pending && VGA_VS && !vsync_reg;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            shadow_bg      <= 24'hC0C040; // bg.mif's sky
+            shadow_ball_x  <= 10'h3FF;    // Hidden
+            shadow_ball_y  <= 10'd0;
+            active_bg      <= 24'hC0C040;
+            active_ball_x  <= 10'h3FF;
+            active_ball_y  <= 10'd0;
+            commit_pending <= 1'b0;
+        end else begin
+            if (reg_write && address == REG_BG)
+                shadow_bg <= writedata[23:0];
+            if (reg_write && address == REG_BALL) begin
+                shadow_ball_x <= writedata[9:0];
+                shadow_ball_y <= writedata[25:16];
+            end
+            if (cmd_exec && cmd_op == CMD_SET_BG)
+                shadow_bg <= cmd_payload;
+            if (cmd_exec && cmd_op == CMD_SET_BALL) begin
+                shadow_ball_x <= cmd_payload[9:0];
+                shadow_ball_y <= cmd_payload[19:10];
+            end
+
+            if (commit_now || commit_vsync) begin
+                active_bg      <= shadow_bg;
+                active_ball_x  <= shadow_ball_x;
+                active_ball_y  <= shadow_ball_y;
+                commit_pending <= 1'b0;
+            end else if (reg_write && address == REG_COMMIT && writedata[0])
+                commit_pending <= 1'b1;
+        end
+    end
+
+    assign ball_dx    = $signed({1'b0, cx}) - $signed({1'b0, active_ball_x});
+    assign ball_dy    = $signed({1'b0, cy}) - $signed({1'b0, active_ball_y});
+    assign ball_pixel = active_ball_x < 10'd640 &&
+                        ball_dx > -BALL_RADIUS && ball_dx < BALL_RADIUS &&
+                        ball_dy > -BALL_RADIUS && ball_dy < BALL_RADIUS &&
+                        ball_dx * ball_dx + ball_dy * ball_dy <
+                        BALL_RADIUS * BALL_RADIUS;
+
+    // === Status readback (REG_STATUS and up, readLatency 1) ===
+    // Reading REG_STATUS takes a snapshot of the game state and the
+    // counters; reading REG_FRAME takes one of the counters only; reading
+    // REG_ACTIVE_BG takes one of the active display set.  The other
+    // status registers return the snapshot, so a read sequence starting
+    // at one of those sees a single moment.
+    //   REG_STATUS       {flap_pending[22:20], game_state[17:16], score}
+    //   REG_BIRD_Y       bird_y
+    //   REG_PIPE0 + i    {gap_y[24:16], x[9:0]}
+    //   REG_FLAP_COUNTS  {flaps_dropped, flaps_received}
+    //   REG_FRAME, REG_VSYNC_CYCLES, REG_CYCLES_LO, REG_CYCLES_HI
+    //   REG_ACTIVE_BG, REG_ACTIVE_BALL, REG_COMMIT_PENDING
+    // REG_CMD_LEVEL, REG_CMD_OVERFLOWS, REG_EVENTS, REG_DMA_UNDERRUNS,
+    // REG_SPRITE_DROPS, REG_DMA_BUSY and the sprite and image tables are
+    // live, not snapshots.
+    logic [15:0] snap_score;
+    logic [9:0]  snap_bird_y;
+    logic [1:0]  snap_state;
+    logic [2:0]  snap_flap_pending;
+    logic [15:0] snap_flaps_received, snap_flaps_dropped;
+    pipe_t       snap_pipes[PIPE_COUNT];
+    logic [31:0] snap_frame, snap_vsync_cycles;
+    logic [63:0] snap_cycles;
+    logic [9:0]  snap_ball_x, snap_ball_y;
+    logic        snap_commit_pending;
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            readdata    <= 32'd0;
+            snap_score  <= 16'd0;
+            snap_bird_y <= 10'd0;
+            snap_state  <= WAITING;
+            snap_flap_pending   <= 3'd0;
+            snap_flaps_received <= 16'd0;
+            snap_flaps_dropped  <= 16'd0;
+            for (int j = 0; j < PIPE_COUNT; j = j + 1)
+                snap_pipes[j] <= '0;
+            snap_frame        <= 32'd0;
+            snap_vsync_cycles <= 32'd0;
+            snap_cycles       <= 64'd0;
+            snap_ball_x <= 10'd0;
+            snap_ball_y <= 10'd0;
+            snap_commit_pending <= 1'b0;
+        end else if (chipselect && read) begin
+            if (address == REG_STATUS || address == REG_FRAME) begin
+                snap_frame        <= frame_count;
+                snap_vsync_cycles <= vsync_cycles;
+                snap_cycles       <= cycle_count;
+            end
+
+            case (address)
+                REG_STATUS: begin
+                    snap_score  <= score;
+                    snap_bird_y <= bird_y;
+                    snap_state  <= game_state;
+                    snap_flap_pending   <= flap_pending;
+                    snap_flaps_received <= flaps_received;
+                    snap_flaps_dropped  <= flaps_dropped;
+                    for (int j = 0; j < PIPE_COUNT; j = j + 1)
+                        snap_pipes[j] <= pipes[j];
+                    readdata <= {9'b0, flap_pending, 2'b0, game_state, score};
+                end
+                REG_BIRD_Y:      readdata <= {22'b0, snap_bird_y};
+                REG_PIPE0:       readdata <= {7'b0, snap_pipes[0].gap_y,
+                                              6'b0, snap_pipes[0].x};
+                REG_PIPE0 + 1:   readdata <= {7'b0, snap_pipes[1].gap_y,
+                                              6'b0, snap_pipes[1].x};
+                REG_PIPE0 + 2:   readdata <= {7'b0, snap_pipes[2].gap_y,
+                                              6'b0, snap_pipes[2].x};
+                REG_FLAP_COUNTS: readdata <= {snap_flaps_dropped,
+                                              snap_flaps_received};
+                REG_FRAME:        readdata <= frame_count;
+                REG_VSYNC_CYCLES: readdata <= snap_vsync_cycles;
+                REG_CYCLES_LO:    readdata <= snap_cycles[31:0];
+                REG_CYCLES_HI:    readdata <= snap_cycles[63:32];
+                REG_ACTIVE_BG: begin
+                    snap_ball_x <= active_ball_x;
+                    snap_ball_y <= active_ball_y;
+                    snap_commit_pending <= commit_pending;
+                    readdata <= {8'b0, active_bg};
+                end
+                REG_ACTIVE_BALL:    readdata <= {6'b0, snap_ball_y,
+                                                 6'b0, snap_ball_x};
+                REG_COMMIT_PENDING: readdata <= {31'b0, snap_commit_pending};
+                REG_CMD_LEVEL:      readdata <= {25'b0, cmd_level};
+                REG_CMD_OVERFLOWS:  readdata <= cmd_overflows;
+                REG_EVENTS:         readdata <= {score, 6'b0, game_state,
+                                                 5'b0, events};
+                REG_DMA_UNDERRUNS:  readdata <= dma_underruns;
+                REG_SPRITE_DROPS:   readdata <= sprite_drops;
+                REG_DMA_BUSY:       readdata <= {31'b0, dma_fetching};
+                default: readdata <= sprite_readdata;
+            endcase
+        end
+    end
+
+    // === Run-length ground ===
+    // The ground, rows 440-479, is stored run-length encoded by
+    // tools/mif2rle: ground_rom holds the address of each row's first run,
+    // then the runs, {color, length - 1}.  Once the composer is done with a
+    // line, the decoder finds the run under the scroll offset in the row
+    // the next line composes, a run per clock; while that line is composed
+    // it steps a pixel per clock, back to the row's first run after column
+    // 639.  ground_rom answers in the clock it gets its address, so the
+    // color is delayed to arrive COMPOSE_LATENCY clocks after cx.
+    localparam GROUND_Y    = 440,
+               GROUND_SEEK = 11'd800;   // hcount; composing ends at 641
+
+    typedef enum logic [1:0] {
+        RLE_IDLE, RLE_INDEX, RLE_SEEK, RLE_READY
+    } rle_state_t;
+
+    rle_state_t  rle_state;
+    logic [8:0]  rle_addr, rle_next;    // Word on ground_rom's q, and next
+    logic [15:0] rle_word;
+    logic [7:0]  run_color, run_last;   // Of the run in rle_word
+    logic [8:0]  rle_row;               // The row's first run
+    logic [9:0]  rle_col;               // Column now; run start in RLE_SEEK
+    logic [7:0]  rle_pos;               // Pixel within the run
+    logic [9:0]  rle_target;            // Column the line starts at
+    logic [7:0]  ground_pipe;
+
+    ground_rom ground_inst (.address(rle_next), .clock(clk), .q(rle_word));
+
+    assign run_color = rle_word[15:8];
+    assign run_last  = rle_word[7:0];
 
     always_comb begin
-        if (vcount >= 440 && vcount < 480)
-            ground_addr = (vcount - 440) * 640 + ((hcount[10:1] + scroll_offset) % 640);
+        rle_next = rle_addr;
+        if (hcount == GROUND_SEEK)
+            rle_next = fetch_y - GROUND_Y;  // The row's index
         else
-            ground_addr = 0;
+            case (rle_state)
+                RLE_INDEX: rle_next = rle_word[8:0];
+                RLE_SEEK:
+                    if (rle_target >= rle_col + run_last + 10'd1)
+                        rle_next = rle_addr + 9'd1;
+                RLE_READY:
+                    if (composing) begin
+                        if (rle_col == 10'd639)
+                            rle_next = rle_row;
+                        else if (rle_pos == run_last)
+                            rle_next = rle_addr + 9'd1;
+                    end
+                default: ;
+            endcase
+    end
+
+    always_ff @(posedge clk or posedge reset) begin
+        if (reset) begin
+            rle_state  <= RLE_IDLE;
+            rle_addr   <= 9'd0;
+            rle_row    <= 9'd0;
+            rle_col    <= 10'd0;
+            rle_pos    <= 8'd0;
+            rle_target <= 10'd0;
+        end else begin
+            rle_addr <= rle_next;
+            if (hcount == GROUND_SEEK) begin
+                rle_state  <= fetch_y >= GROUND_Y && fetch_y < 10'd480 ?
+                              RLE_INDEX : RLE_IDLE;
+                rle_target <= scroll_offset;
+            end else
+                case (rle_state)
+                    RLE_INDEX: begin
+                        rle_row   <= rle_word[8:0];
+                        rle_col   <= 10'd0;
+                        rle_state <= RLE_SEEK;
+                    end
+                    RLE_SEEK:
+                        if (rle_target >= rle_col + run_last + 10'd1)
+                            rle_col <= rle_col + run_last + 10'd1;
+                        else begin
+                            rle_pos   <= rle_target - rle_col;
+                            rle_col   <= rle_target;
+                            rle_state <= RLE_READY;
+                        end
+                    RLE_READY:
+                        if (composing) begin
+                            if (rle_col == 10'd639) begin
+                                rle_col <= 10'd0;
+                                rle_pos <= 8'd0;
+                            end else begin
+                                rle_col <= rle_col + 10'd1;
+                                rle_pos <= rle_pos == run_last ?
+                                           8'd0 : rle_pos + 8'd1;
+                            end
+                        end
+                    default: ;
+                endcase
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        ground_pipe  <= run_color;
+        ground_color <= ground_pipe;
     end
 
     logic pipe_pixel;
@@ -386,64 +1306,64 @@ module vga_ball(
         // Digit0 segments
         if (seg0[6] && in_rect(SCORE_X0 + SEG_THICK, SCORE_Y0,
                              DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                             hcount[10:1], vcount))
+                             cx, cy))
             score_pixel = 1;
         // Other segment checks...
         // (keeping the existing segment rendering code)
         if (seg0[5] && in_rect(SCORE_X0 + DIGIT_WIDTH - SEG_THICK, SCORE_Y0 + SEG_THICK,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg0[4] && in_rect(SCORE_X0 + DIGIT_WIDTH - SEG_THICK, SCORE_Y0 + DIGIT_HEIGHT/2,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg0[3] && in_rect(SCORE_X0 + SEG_THICK, SCORE_Y0 + DIGIT_HEIGHT - SEG_THICK,
                                 DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg0[2] && in_rect(SCORE_X0, SCORE_Y0 + DIGIT_HEIGHT/2,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg0[1] && in_rect(SCORE_X0, SCORE_Y0 + SEG_THICK,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg0[0] && in_rect(SCORE_X0 + SEG_THICK, SCORE_Y0 + DIGIT_HEIGHT/2 - SEG_THICK/2,
                                 DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         
         // Digit1 segments
         // (keeping the existing digit1 segment rendering code)
         if (seg1[6] && in_rect(SCORE_X1 + SEG_THICK, SCORE_Y1,
                                 DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[5] && in_rect(SCORE_X1 + DIGIT_WIDTH - SEG_THICK, SCORE_Y1 + SEG_THICK,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[4] && in_rect(SCORE_X1 + DIGIT_WIDTH - SEG_THICK, SCORE_Y1 + DIGIT_HEIGHT/2,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[3] && in_rect(SCORE_X1 + SEG_THICK, SCORE_Y1 + DIGIT_HEIGHT - SEG_THICK,
                                 DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[2] && in_rect(SCORE_X1, SCORE_Y1 + DIGIT_HEIGHT/2,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[1] && in_rect(SCORE_X1, SCORE_Y1 + SEG_THICK,
                                 SEG_THICK, DIGIT_HEIGHT/2 - SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
         if (seg1[0] && in_rect(SCORE_X1 + SEG_THICK, SCORE_Y1 + DIGIT_HEIGHT/2 - SEG_THICK/2,
                                 DIGIT_WIDTH - 2*SEG_THICK, SEG_THICK,
-                                hcount[10:1], vcount))
+                                cx, cy))
             score_pixel = 1;
     end
     
@@ -453,9 +1373,9 @@ module vga_ball(
         // Only show pipes when not in WAITING state
         if (game_state != WAITING) begin
             for (int j = 0; j < PIPE_COUNT; j = j + 1) begin
-                if (hcount[10:1] >= pipes[j].x && hcount[10:1] < pipes[j].x + PIPE_WIDTH) begin
-                    if ((vcount < pipes[j].gap_y || vcount > pipes[j].gap_y + GAP_HEIGHT) &&
-                        vcount < 440)
+                if (cx >= pipes[j].x && cx < pipes[j].x + PIPE_WIDTH) begin
+                    if ((cy < pipes[j].gap_y || cy > pipes[j].gap_y + GAP_HEIGHT) &&
+                        cy < 440)
                         pipe_pixel = 1;
                 end
             end
@@ -490,58 +1410,19 @@ module vga_ball(
             end
         end
     end
-  
-    // Rendering logic
+
+    // What covers the composer's pixel, for its priority mux
+    assign layers[LAYER_SCORE]    = score_pixel;
+    assign layers[LAYER_BALL]     = ball_pixel;
+    assign layers[LAYER_PIPE]     = pipe_pixel;
+    assign layers[LAYER_GROUND]   = cy >= 440;
+
+    // Scanout: the line buffer, one clock behind hcount
     always_comb begin
         {VGA_R, VGA_G, VGA_B} = 24'h000000;
 
-        if (VGA_BLANK_n) begin
-            // Render score (highest priority)
-				if (game_state == GAME_OVER && in_rect(GAMEOVER_X, GAMEOVER_Y, GAMEOVER_WIDTH, GAMEOVER_HEIGHT, hcount[10:1], vcount) && 
-                gameover_color != 8'h00) begin
-                VGA_R = {gameover_color[7:5], 5'b00000};
-                VGA_G = {gameover_color[4:2], 5'b00000};
-                VGA_B = {gameover_color[1:0], 6'b000000};
-				//rendering score
-            end else if (score_pixel) begin
-                VGA_R = 8'hFF;
-                VGA_G = 8'hFF;
-                VGA_B = 8'hFF;
-            end
-            // Render bird
-            else if (hcount[10:1] >= BIRD_X && hcount[10:1] < BIRD_X + BIRD_WIDTH &&
-                     vcount >= bird_y && vcount < bird_y + BIRD_HEIGHT &&
-                     bird_color_reg != 8'h00) begin
-                VGA_R = {bird_color_reg[7:5], 5'b00000};
-                VGA_G = {bird_color_reg[4:2], 5'b00000};
-                VGA_B = {bird_color_reg[1:0], 6'b000000};
-            end 
-            // Render pipes (only if not in WAITING state)
-            else if (pipe_pixel) begin
-                VGA_R = 8'h00;
-                VGA_G = 8'hFF;
-                VGA_B = 8'h00;
-            end 
-            // Render ground
-            else if (vcount >= 440 && vcount < 480) begin
-                VGA_R = {ground_color[7:5], 5'b00000};
-					 VGA_G = {ground_color[4:2], 5'b00000};
-					 VGA_B = {ground_color[1:0], 6'b000000};
-            end 
-            // Render background
-            else begin
-                VGA_B = {bg_color[7:5], 5'b00000};
-                VGA_G = {bg_color[4:2], 5'b00000};
-                VGA_R = {bg_color[1:0], 6'b000000};
-            end
-            
-				/*
-            // Add a red tint in GAME_OVER state
-            if (game_state == GAME_OVER) begin
-                VGA_R = VGA_R | 8'h40; // Add some red tint
-            end
-				*/
-        end
+        if (VGA_BLANK_n)
+            {VGA_R, VGA_G, VGA_B} = line_pixel;
     end
 endmodule
 
@@ -99,8 +99,8 @@ set_interface_property avalon_slave_0 holdTime 0
 set_interface_property avalon_slave_0 linewrapBursts false
 set_interface_property avalon_slave_0 maximumPendingReadTransactions 0
 set_interface_property avalon_slave_0 maximumPendingWriteTransactions 0
-set_interface_property avalon_slave_0 readLatency 0
-set_interface_property avalon_slave_0 readWaitTime 1
+set_interface_property avalon_slave_0 readLatency 1
+set_interface_property avalon_slave_0 readWaitTime 0
 set_interface_property avalon_slave_0 setupTime 0
 set_interface_property avalon_slave_0 timingUnits Cycles
 set_interface_property avalon_slave_0 writeWaitTime 0
@@ -110,16 +110,71 @@ set_interface_property avalon_slave_0 PORT_NAME_MAP ""
 set_interface_property avalon_slave_0 CMSIS_SVD_VARIABLES ""
 set_interface_property avalon_slave_0 SVD_ADDRESS_GROUP ""
 
-add_interface_port avalon_slave_0 writedata writedata Input 8
+add_interface_port avalon_slave_0 writedata writedata Input 32
 add_interface_port avalon_slave_0 write write Input 1
+add_interface_port avalon_slave_0 read read Input 1
+add_interface_port avalon_slave_0 readdata readdata Output 32
 add_interface_port avalon_slave_0 chipselect chipselect Input 1
-add_interface_port avalon_slave_0 address address Input 3
+add_interface_port avalon_slave_0 address address Input 8
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isFlash 0
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isMemoryDevice 0
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isNonVolatileStorage 0
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isPrintableDevice 0
 
 
+# 
+# connection point avalon_master_0
+# 
+add_interface avalon_master_0 avalon start
+set_interface_property avalon_master_0 addressUnits SYMBOLS
+set_interface_property avalon_master_0 associatedClock clock
+set_interface_property avalon_master_0 associatedReset reset
+set_interface_property avalon_master_0 bitsPerSymbol 8
+set_interface_property avalon_master_0 burstOnBurstBoundariesOnly false
+set_interface_property avalon_master_0 burstcountUnits WORDS
+set_interface_property avalon_master_0 doStreamReads false
+set_interface_property avalon_master_0 doStreamWrites false
+set_interface_property avalon_master_0 holdTime 0
+set_interface_property avalon_master_0 linewrapBursts false
+set_interface_property avalon_master_0 maximumPendingReadTransactions 0
+set_interface_property avalon_master_0 maximumPendingWriteTransactions 0
+set_interface_property avalon_master_0 readLatency 0
+set_interface_property avalon_master_0 readWaitTime 1
+set_interface_property avalon_master_0 setupTime 0
+set_interface_property avalon_master_0 timingUnits Cycles
+set_interface_property avalon_master_0 writeWaitTime 0
+set_interface_property avalon_master_0 ENABLED true
+set_interface_property avalon_master_0 EXPORT_OF ""
+set_interface_property avalon_master_0 PORT_NAME_MAP ""
+set_interface_property avalon_master_0 CMSIS_SVD_VARIABLES ""
+set_interface_property avalon_master_0 SVD_ADDRESS_GROUP ""
+
+add_interface_port avalon_master_0 dma_address address Output 32
+add_interface_port avalon_master_0 dma_burstcount burstcount Output 6
+add_interface_port avalon_master_0 dma_read read Output 1
+add_interface_port avalon_master_0 dma_readdata readdata Input 32
+add_interface_port avalon_master_0 dma_waitrequest waitrequest Input 1
+add_interface_port avalon_master_0 dma_readdatavalid readdatavalid Input 1
+
+
+# 
+# connection point interrupt_sender
+# 
+add_interface interrupt_sender interrupt end
+set_interface_property interrupt_sender associatedAddressablePoint avalon_slave_0
+set_interface_property interrupt_sender associatedClock clock
+set_interface_property interrupt_sender associatedReset reset
+set_interface_property interrupt_sender bridgedReceiverOffset ""
+set_interface_property interrupt_sender bridgesToReceiver ""
+set_interface_property interrupt_sender ENABLED true
+set_interface_property interrupt_sender EXPORT_OF ""
+set_interface_property interrupt_sender PORT_NAME_MAP ""
+set_interface_property interrupt_sender CMSIS_SVD_VARIABLES ""
+set_interface_property interrupt_sender SVD_ADDRESS_GROUP ""
+
+add_interface_port interrupt_sender irq irq Output 1
+
+
 # 
 # connection point vga
 # 